@@ -0,0 +1,219 @@
+/*!
+	@file    main.cpp
+	@author   Gavin Lyons
+	@brief
+		 Bus cost benchmark for the HD44780_LCD_PCF8574 pico rp2040 library.
+		 Times common API calls and prints the results to the serial console.
+		 This is for 20 column 4 row LCD.
+	@note
+		-# Test 1 :: Init sequence
+		-# Test 2 :: LCDClearScreen versus LCDClearScreenCmd
+		-# Test 3 :: String write, one character per transaction versus batched
+		-# Test 4 :: Full screen redraw versus buffered mode flush of a changed field
+		-# Test 5 :: Number printing, print(double) versus fixed point printFixed
+		-# Test 6 :: Encoding throughput, 4K byte buffer to PCF8574 port bytes, no I2C
+		-# Bus counters and latency histogram for the whole run, see LCDStatsGet
+*/
+
+// Section: Included library
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+
+// Section: Defines
+#define DISPLAY_DELAY 2000
+#define BENCH_LOOPS 10
+#define ENCODE_SIZE 4096
+
+// Section: Globals
+#define CLOCK_PIN 19
+#define DATA_PIN  18
+#define CLOCK_SPEED 100
+#define I2C_ADDRESS 0x27
+HD44780LCD myLCD(I2C_ADDRESS, i2c1, CLOCK_SPEED, DATA_PIN, CLOCK_PIN);
+
+// Section: Function Prototypes
+void benchInit(void);
+void benchClear(void);
+void benchString(void);
+void benchFlush(void);
+void benchPrint(void);
+void benchEncode(void);
+void benchStats(void);
+void benchReport(const char *name, uint64_t startTime, uint32_t loops);
+
+// Section: Main Loop
+int main()
+{
+	stdio_init_all(); // Initialize chosen serial port, default 38400 baud
+	busy_wait_ms(1000);
+	printf("HD44780 : Benchmark Start!\r\n");
+	printf("I2C clock %u kHz, times are per call.\r\n", CLOCK_SPEED);
+
+	benchInit();
+	myLCD.LCDBackLightSet(true);
+	benchClear();
+	benchString();
+	benchFlush();
+	benchPrint();
+	benchEncode();
+	benchStats();
+
+	myLCD.LCDClearScreenCmd();
+	myLCD.LCDDeInit();
+	printf("HD44780 : Benchmark End!\r\n");
+	return 0;
+}
+// End of Main
+
+// Section : Functions
+
+void benchReport(const char *name, uint64_t startTime, uint32_t loops)
+{
+	uint64_t elapsed = time_us_64() - startTime;
+	printf("%-28s %8llu uS\r\n", name, (unsigned long long)(elapsed / loops));
+}
+
+void benchInit(void)
+{
+	uint64_t startTime = time_us_64();
+	if(!myLCD.LCDInit(myLCD.LCDCursorTypeOff, 4, 20))
+	{
+		printf("Error : benchInit : Failed to Init I2C!\r\n");
+		while (true) {tight_loop_contents();}
+	}
+	benchReport("LCDInit", startTime, 1);
+}
+
+void benchClear(void)
+{
+	uint64_t startTime = time_us_64();
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDClearScreen();
+	}
+	benchReport("LCDClearScreen", startTime, BENCH_LOOPS);
+
+	startTime = time_us_64();
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDClearScreenCmd();
+	}
+	benchReport("LCDClearScreenCmd", startTime, BENCH_LOOPS);
+}
+
+void benchString(void)
+{
+	char testString[] = "Benchmark 0123456789";
+	uint8_t batchSize = myLCD.LCDI2CBatchSizeGet();
+
+	myLCD.LCDI2CBatchSizeSet(1);
+	uint64_t startTime = time_us_64();
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDGOTO(myLCD.LCDLineNumberOne, 0);
+		myLCD.LCDSendString(testString);
+	}
+	benchReport("20 chars, batch size 1", startTime, BENCH_LOOPS);
+
+	myLCD.LCDI2CBatchSizeSet(batchSize);
+	startTime = time_us_64();
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDGOTO(myLCD.LCDLineNumberTwo, 0);
+		myLCD.LCDSendString(testString);
+	}
+	benchReport("20 chars, batched", startTime, BENCH_LOOPS);
+	busy_wait_ms(DISPLAY_DELAY);
+}
+
+void benchFlush(void)
+{
+	char rowString[] = "Temp:    21.5 C    ";
+	uint16_t bytesSent = 0;
+
+	// Redraw all 4 rows every frame, as an application without buffered mode would
+	uint64_t startTime = time_us_64();
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		for (uint8_t row = 1; row <= 4; row++) {
+			myLCD.LCDGOTO((HD44780LCD::LCDLineNumber_e)row, 0);
+			myLCD.LCDSendString(rowString);
+		}
+	}
+	benchReport("Redraw 4 rows", startTime, BENCH_LOOPS);
+
+	// Same frames in buffered mode , only the changed digit is sent
+	myLCD.LCDBufferModeSet(true);
+	for (uint8_t row = 1; row <= 4; row++) {
+		myLCD.LCDGOTO((HD44780LCD::LCDLineNumber_e)row, 0);
+		myLCD.LCDSendString(rowString);
+	}
+	myLCD.LCDFlush();
+	startTime = time_us_64();
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDGOTO(myLCD.LCDLineNumberOne, 12);
+		myLCD.print(i);
+		bytesSent += myLCD.LCDFlush();
+	}
+	benchReport("Buffered flush, 1 digit", startTime, BENCH_LOOPS);
+	printf("%-28s %8u bytes\r\n", "Buffered flush, bus bytes", bytesSent / BENCH_LOOPS);
+	myLCD.LCDBufferModeSet(false);
+	busy_wait_ms(DISPLAY_DELAY);
+}
+
+void benchPrint(void)
+{
+	double temperature = -12.345;
+	int32_t temperatureFixed = -12345; // milli degrees
+
+	uint64_t startTime = time_us_64();
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDGOTO(myLCD.LCDLineNumberThree, 0);
+		myLCD.print(temperature, 3);
+	}
+	benchReport("print(double, 3)", startTime, BENCH_LOOPS);
+
+	startTime = time_us_64();
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDGOTO(myLCD.LCDLineNumberFour, 0);
+		myLCD.printFixed(temperatureFixed, 3);
+	}
+	benchReport("printFixed(int32_t, 3)", startTime, BENCH_LOOPS);
+	busy_wait_ms(DISPLAY_DELAY);
+}
+
+void benchEncode(void)
+{
+	static uint8_t source[ENCODE_SIZE];
+	static uint8_t encoded[4 * ENCODE_SIZE];
+	uint32_t checksum = 0;
+
+	for (uint16_t i = 0; i < ENCODE_SIZE; i++) {source[i] = (uint8_t)i;}
+	uint64_t startTime = time_us_64();
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDEncode(source, ENCODE_SIZE, true, encoded);
+		checksum += encoded[i];
+	}
+	uint64_t elapsed = time_us_64() - startTime;
+	benchReport("Encode 4K bytes", startTime, BENCH_LOOPS);
+	if (elapsed > 0) {
+		printf("%-28s %8llu KB/s (%lu)\r\n", "Encode throughput",
+			(unsigned long long)((uint64_t)ENCODE_SIZE * BENCH_LOOPS * 1000 / elapsed), (unsigned long)checksum);
+	}
+}
+
+void benchStats(void)
+{
+	HD44780LCD::LCDStats_t stats;
+	if (!myLCD.LCDStatsGet(stats)) {return;}
+
+	printf("%-28s %8lu\r\n", "I2C transactions", (unsigned long)stats.transactions);
+	printf("%-28s %8lu\r\n", "I2C bytes", (unsigned long)stats.bytes);
+	printf("%-28s %8lu\r\n", "Characters", (unsigned long)stats.characters);
+	printf("%-28s %8lu\r\n", "Commands", (unsigned long)stats.commands);
+	printf("%-28s %8lu / %lu\r\n", "NACKs / timeouts", (unsigned long)stats.nacks, (unsigned long)stats.timeouts);
+	printf("%-28s %8lu / %lu\r\n", "Retries / recoveries", (unsigned long)stats.retries, (unsigned long)stats.recoveries);
+	printf("%-28s %8llu uS\r\n", "Bus busy time", (unsigned long long)stats.busyTime);
+	for (uint8_t bucket = 0; bucket < HD44780LCD::LCDStatsBuckets; bucket++) {
+		if (stats.latency[bucket] == 0) {continue;}
+		printf("Latency >= %6lu uS        %8lu\r\n", (unsigned long)(bucket ? (1ul << bucket) : 0), (unsigned long)stats.latency[bucket]);
+	}
+}
+
+// *** EOF ***
@@ -0,0 +1,390 @@
+#!/usr/bin/env python3
+"""
+Decode an I2C trace dumped by HD44780LCD::LCDTraceDump, replay it into a model of
+the HD44780 and report bytes and time the library could have saved.
+
+Build the library with HD44780_LCD_TRACE=1, call LCDTraceModeSet(true), run the
+screen update under test, call LCDTraceDump() and capture the stdio port to a file :
+
+    python3 hd44780_trace.py capture.bin
+    python3 hd44780_trace.py capture.bin --ops
+
+Text printed before and after a dump is skipped, several dumps in one file are
+replayed in order. No hardware is needed, only the captured file.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"HDT1"
+HEADER = struct.Struct("<4sBBHII")  # magic, rows, cols, clock KHz, dropped records, record bytes
+RECORD = struct.Struct("<IHHHB")  # time uS, wait uS, write uS, length, flags
+
+FLAG_ERROR = 0x01
+FLAG_ASYNC = 0x02
+FLAG_TRUNCATED = 0x04
+FLAG_READ = 0x08  # port bytes are the ones read back, not written
+
+PORT_RS = 0x01
+PORT_RW = 0x02
+PORT_EN = 0x04
+
+EXEC_US_SLOW = 1520  # clear display and return home
+EXEC_US = 37  # all other instructions
+DDRAM_LINE = 40
+PORT_BYTES_PER_OP = 4  # two nibbles, each with enable high and low
+
+
+class Dump:
+    """One LCDTraceDump, header fields and records of (time, wait, duration, flags, port bytes)."""
+
+    def __init__(self, rows, cols, clock, dropped, records):
+        self.rows = rows
+        self.cols = cols
+        self.clock = clock
+        self.dropped = dropped
+        self.records = records
+
+
+def find_dumps(data):
+    """Yield every dump in a capture, skipping any text around them."""
+    start = 0
+    while True:
+        start = data.find(MAGIC, start)
+        if start < 0 or start + HEADER.size > len(data):
+            return
+        _, rows, cols, clock, dropped, length = HEADER.unpack_from(data, start)
+        body = data[start + HEADER.size:start + HEADER.size + length]
+        if len(body) < length:
+            print("warning: dump at offset %d is cut short" % start, file=sys.stderr)
+        records = []
+        offset = 0
+        while offset + RECORD.size <= len(body):
+            time, wait, duration, count, flags = RECORD.unpack_from(body, offset)
+            offset += RECORD.size
+            records.append((time, wait, duration, flags, body[offset:offset + count]))
+            offset += count
+        yield Dump(rows, cols, clock, dropped, records)
+        start += HEADER.size + length
+
+
+class Op:
+    """One instruction, data write or busy flag read decoded from the port bytes."""
+
+    def __init__(self, record, kind, value):
+        self.record = record
+        self.kind = kind  # "cmd", "data" or "read"
+        self.value = value
+        self.waste = None  # reason the op was not needed
+
+
+class Decoder:
+    """Turns PCF8574 port bytes back into HD44780 operations, enable falling edge latches a nibble."""
+
+    def __init__(self):
+        self.eight_bit = False
+        self.enable = False
+        self.half = None
+        self.read_half = False
+
+    def feed(self, record, port_bytes):
+        ops = []
+        for port in port_bytes:
+            enable = bool(port & PORT_EN)
+            if self.enable and not enable:
+                if port & PORT_RW:
+                    # busy flag or address read, two strobes in 4 bit mode
+                    if self.eight_bit or self.read_half:
+                        ops.append(Op(record, "read", None))
+                        self.read_half = False
+                    else:
+                        self.read_half = True
+                elif self.eight_bit:
+                    ops.append(self.op(record, port & 0xF0, port & PORT_RS))
+                elif self.half is None:
+                    self.half = (port & 0xF0, port & PORT_RS)
+                else:
+                    ops.append(self.op(record, self.half[0] | (port >> 4), self.half[1]))
+                    self.half = None
+            self.enable = enable
+        return ops
+
+    def op(self, record, value, rs):
+        if not rs and value & 0xE0 == 0x20:
+            self.eight_bit = bool(value & 0x10)  # function set, resync uses 0x33 then 0x30
+        return Op(record, "data" if rs else "cmd", value)
+
+
+class Model:
+    """HD44780 state, None where the trace has not shown it yet."""
+
+    def __init__(self):
+        self.ddram = [None] * 128
+        self.cgram = [None] * 64
+        self.address = None
+        self.cgram_mode = False
+        self.increment = True
+        self.entry_shift = False
+        self.shift = None
+        self.display_control = None
+        self.entry_mode = None
+
+    @staticmethod
+    def step_ddram(address, increment):
+        address += 1 if increment else -1
+        return {0x28: 0x40, 0x68: 0x00, 0x3F: 0x27, -1: 0x67}.get(address, address)
+
+    def execute(self, op):
+        """Apply one op, return True if it changed nothing a later op depends on."""
+        value = op.value
+        if op.kind == "read":
+            return False
+        if op.kind == "data":
+            if self.address is None:
+                return False
+            if self.cgram_mode:
+                same = self.cgram[self.address] == value
+                self.cgram[self.address] = value
+                self.address = (self.address + 1) & 0x3F
+                return same
+            same = self.ddram[self.address] == value and not self.entry_shift
+            self.ddram[self.address] = value
+            self.address = self.step_ddram(self.address, self.increment)
+            if self.entry_shift and self.shift is not None:
+                self.shift = (self.shift + (-1 if self.increment else 1)) % DDRAM_LINE
+            return same
+        if value & 0x80:
+            same = not self.cgram_mode and self.address == value & 0x7F
+            self.address = value & 0x7F
+            self.cgram_mode = False
+            return same
+        if value & 0x40:
+            same = self.cgram_mode and self.address == value & 0x3F
+            self.address = value & 0x3F
+            self.cgram_mode = True
+            return same
+        if value & 0x20:
+            return False
+        if value & 0x10:
+            step = 1 if value & 0x04 else -1
+            if value & 0x08:
+                if self.shift is not None:
+                    self.shift = (self.shift + step) % DDRAM_LINE
+            elif self.address is not None:
+                if self.cgram_mode:
+                    self.address = (self.address + step) & 0x3F
+                else:
+                    self.address = self.step_ddram(self.address, step > 0)
+            return False
+        if value & 0x08:
+            same = self.display_control == value
+            self.display_control = value
+            return same
+        if value & 0x04:
+            same = self.entry_mode == value
+            self.entry_mode = value
+            self.increment = bool(value & 0x02)
+            self.entry_shift = bool(value & 0x01)
+            return same
+        if value & 0x01:
+            self.ddram = [0x20] * 128
+            self.increment = True
+        if value & 0x03:
+            self.address = 0
+            self.cgram_mode = False
+            self.shift = 0
+        return False
+
+    def screen(self, rows, cols):
+        """Visible rows as text, '?' for cells the trace never wrote."""
+        lines = []
+        shift = self.shift or 0
+        for line in range(1, rows + 1):
+            text = ""
+            for col in range(cols):
+                if rows == 1 and cols == 16 and col >= 8:
+                    cell = 0x40 + col - 8
+                else:
+                    cell = (0x40 if line in (2, 4) else 0x00) + (cols if line >= 3 else 0) + col
+                address = (cell & 0x40) + ((cell & 0x3F) - shift) % DDRAM_LINE
+                value = self.ddram[address]
+                text += "?" if value is None else (chr(value) if 0x20 <= value < 0x7F else ".")
+            lines.append(text)
+        return lines
+
+
+def exec_time(op):
+    if op.kind == "cmd" and op.value in (0x01, 0x02, 0x03):
+        return EXEC_US_SLOW
+    return EXEC_US
+
+
+class Analyser:
+    """Replays dumps into the model and marks operations that changed nothing."""
+
+    COUNTERS = ("transactions", "single", "port", "errors", "async", "dropped",
+                "port reads", "ops", "data", "cmds", "reads",
+                "same data", "address there", "address dead", "repeat control", "shifts cancelled",
+                "bus us", "wait us", "wait excess us")
+    WASTE = ("same data", "address there", "address dead", "repeat control", "shifts cancelled")
+
+    def __init__(self, show_ops):
+        self.show_ops = show_ops
+        self.decoder = Decoder()
+        self.model = Model()
+        self.count = dict.fromkeys(self.COUNTERS, 0)
+        self.rows = 0
+        self.cols = 0
+        self.previous = None  # (end time, last op) of the previous blocking record
+        self.address_ops = []  # address and cursor moves not yet used by a data write or read
+        self.shifts = []  # run of display shifts
+
+    def dump(self, dump):
+        self.rows, self.cols = dump.rows, dump.cols
+        self.count["dropped"] += dump.dropped
+        if dump.dropped:
+            self.previous = None
+        for index, record in enumerate(dump.records):
+            self.record(index, *record)
+        self.close_shifts()
+
+    def record(self, index, time, wait, duration, flags, port_bytes):
+        count = self.count
+        count["transactions"] += 1
+        count["port reads" if flags & FLAG_READ else "port"] += len(port_bytes)
+        count["errors"] += bool(flags & FLAG_ERROR)
+        count["async"] += bool(flags & FLAG_ASYNC)
+        count["bus us"] += duration
+        count["wait us"] += wait
+        if flags & FLAG_TRUNCATED:
+            print("warning: record %d was cut short in the ring" % index, file=sys.stderr)
+
+        if flags & FLAG_READ:
+            # the strobe writes around it already decode as a read op, the controller is unchanged
+            if self.show_ops:
+                print_ops(time, wait, duration, flags, [])
+                print("        port 0x%s" % port_bytes.hex().upper())
+            return
+        ops = self.decoder.feed(index, port_bytes)
+        count["single"] += len(ops) == 1
+        if self.previous is not None and not flags & FLAG_ASYNC and self.previous[1] is not None:
+            since = (time - wait - self.previous[0]) & 0xFFFFFFFF
+            needed = max(0, exec_time(self.previous[1]) - since)
+            count["wait excess us"] += max(0, wait - needed)
+        for op in ops:
+            self.op(op)
+        if self.show_ops:
+            print_ops(time, wait, duration, flags, ops)
+        if not flags & FLAG_ASYNC:
+            self.previous = ((time + duration) & 0xFFFFFFFF, ops[-1] if ops else None)
+
+    def op(self, op):
+        count = self.count
+        count["ops"] += 1
+        count[{"cmd": "cmds", "data": "data", "read": "reads"}[op.kind]] += 1
+        value = op.value if op.kind == "cmd" else 0
+        display_shift = op.kind == "cmd" and value & 0xF8 == 0x18
+        cursor_shift = op.kind == "cmd" and value & 0xF8 == 0x10
+        sets_address = op.kind == "cmd" and (value & 0xC0 or 0 < value < 0x04)
+
+        if not display_shift:
+            self.close_shifts()
+        if sets_address:
+            # address commands and moves since the last data write are overwritten
+            for dead in self.address_ops:
+                if dead.waste is None:
+                    dead.waste = "address overwritten before use"
+                    count["address dead"] += 1
+            self.address_ops = []
+        elif op.kind != "cmd":
+            self.address_ops = []
+
+        same = self.model.execute(op)
+        if display_shift:
+            self.shifts.append(op)
+        elif same and op.kind == "data":
+            self.waste(op, "same data", "same character already there")
+        elif same and value & 0xC0:
+            self.waste(op, "address there", "address counter already there")
+        elif same:
+            self.waste(op, "repeat control", "same as current setting")
+        if cursor_shift or (sets_address and value & 0xC0):
+            self.address_ops.append(op)
+
+    def waste(self, op, counter, reason):
+        op.waste = reason
+        self.count[counter] += 1
+
+    def close_shifts(self):
+        if self.shifts:
+            net = sum(1 if op.value & 0x04 else -1 for op in self.shifts) % DDRAM_LINE
+            needed = min(net, DDRAM_LINE - net)
+            for op in self.shifts[needed:]:
+                self.waste(op, "shifts cancelled", "display shift cancelled by another")
+            self.shifts = []
+
+
+def print_ops(time, wait, duration, flags, ops):
+    notes = [name for bit, name in ((FLAG_ERROR, "error"), (FLAG_ASYNC, "async"), (FLAG_READ, "read")) if flags & bit]
+    print("%10u us  wait %5u  write %5u  %s" % (time, wait, duration, " ".join(notes)))
+    for op in ops:
+        text = "read" if op.kind == "read" else "%s 0x%02X %s" % (op.kind, op.value, describe(op))
+        print("        %s%s" % (text, "  <- " + op.waste if op.waste else ""))
+
+
+def describe(op):
+    value = op.value
+    if op.kind == "data":
+        return repr(chr(value)) if 0x20 <= value < 0x7F else ""
+    for mask, name in ((0x80, "set DDRAM address"), (0x40, "set CGRAM address"), (0x20, "function set"),
+                       (0x10, "shift"), (0x08, "display control"), (0x04, "entry mode"),
+                       (0x02, "home"), (0x01, "clear")):
+        if value & mask:
+            return name
+    return ""
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode and analyse an HD44780 LCD I2C trace.")
+    parser.add_argument("capture", help="file captured from the stdio port, - for stdin")
+    parser.add_argument("--ops", action="store_true", help="list every transaction and operation")
+    args = parser.parse_args()
+
+    if args.capture == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.capture, "rb") as capture:
+            data = capture.read()
+    dumps = list(find_dumps(data))
+    if not dumps:
+        sys.exit("no trace dump found in %s" % args.capture)
+    analyser = Analyser(args.ops)
+    for dump in dumps:
+        analyser.dump(dump)
+
+    count = analyser.count
+    wasted = PORT_BYTES_PER_OP * sum(count[name] for name in Analyser.WASTE)
+    print("Transactions        %8d  (%d of one operation, %d async, %d failed, %d dropped)" % (
+        count["transactions"], count["single"], count["async"], count["errors"], count["dropped"]))
+    print("Port bytes          %8d  (%.1f per transaction, each also costs an I2C address byte, %d read)" % (
+        count["port"], count["port"] / max(1, count["transactions"]), count["port reads"]))
+    print("Operations          %8d  (%d data, %d commands, %d reads)" % (
+        count["ops"], count["data"], count["cmds"], count["reads"]))
+    print("Wasted port bytes   %8d  (%.1f%%)" % (wasted, 100.0 * wasted / max(1, count["port"])))
+    print("  same character rewritten       %6d" % count["same data"])
+    print("  address already there          %6d" % count["address there"])
+    print("  address overwritten before use %6d" % count["address dead"])
+    print("  display control / entry repeat %6d" % count["repeat control"])
+    print("  display shifts cancelled       %6d" % count["shifts cancelled"])
+    print("Write time          %8d us" % count["bus us"])
+    print("Wait for controller %8d us  (%d us longer than the instructions need)" % (
+        count["wait us"], count["wait excess us"]))
+    if analyser.rows and analyser.cols:
+        print("Screen after replay :")
+        for line in analyser.model.screen(analyser.rows, analyser.cols):
+            print("  |%s|" % line)
+
+
+if __name__ == "__main__":
+    main()
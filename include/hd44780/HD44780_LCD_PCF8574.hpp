@@ -9,6 +9,23 @@
 
 #include "HD44780_LCD_PCF8574_Print.hpp"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/sync.h"
+#include <atomic>
+
+#ifndef HD44780_LCD_STATS
+#define HD44780_LCD_STATS 1 /**< 1 = collect bus counters, 0 = compile them out , see LCDStatsGet */
+#endif
+
+#ifndef HD44780_LCD_TRACE
+#define HD44780_LCD_TRACE 0 /**< 1 = record I2C transactions in a RAM ring, see LCDTraceDump */
+#endif
+
+#ifndef HD44780_LCD_TRACE_SIZE
+#define HD44780_LCD_TRACE_SIZE 4096 /**< Bytes of RAM for the trace ring */
+#endif
 
 /*!
 	@brief Class for HD44780 LCD  
@@ -53,35 +70,152 @@ class HD44780LCD : public Print{
 			LCDLineNumberFour = 4  /**<  row 4 */
 		}; 
 
+		/*! Text alignment in a row, see LCDWriteLine */
+		enum LCDAlign_e : uint8_t {
+			LCDAlignLeft = 0,  /**< text starts at column 0 */
+			LCDAlignRight = 1, /**< text ends at last column */
+			LCDAlignCenter = 2 /**< text centred, odd space goes on the right */
+		};
+
 
 		HD44780LCD(uint8_t I2Caddress, i2c_inst_t* i2c_type, uint16_t CLKspeed, uint8_t  SDApin, uint8_t  SCLKpin);
-		~HD44780LCD(){};
+		HD44780LCD(uint8_t I2Caddress, PIO pio, uint sm, uint16_t CLKspeed, uint8_t  SDApin, uint8_t  SCLKpin);
+		~HD44780LCD();
 
 		bool LCDInit (LCDCursorType_e, uint8_t NumRow, uint8_t NumCol);
 		void LCDDeInit(void);
 		void LCDDisplayON(bool );
 		void LCDResetScreen(LCDCursorType_e);
+		uint8_t LCDNumRowsGet(void);
+		uint8_t LCDNumColsGet(void);
 
 		void LCDBackLightSet(bool);
 		bool LCDBackLightGet(void);
 
 		void LCDSerialDebugSet(bool);
 		bool LCDSerialDebugGet(void);
+		void LCDSharedBusSet(bool);
+		bool LCDSharedBusGet(void);
 
-		void LCDSendString (char *str);
+		void LCDSendString (const char *str);
+		void LCDSendString (std::string_view str);
+		size_t LCDPrintf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+		size_t LCDPrintfBuffer(char *buffer, size_t size, const char *format, ...) __attribute__((format(printf, 4, 5)));
 		void LCDSendChar (char data);
 		void LCDCreateCustomChar(uint8_t location, uint8_t* charmap);
 		void LCDPrintCustomChar(uint8_t location);
+		bool LCDCharacterOnScreen(uint8_t character);
 
 		void LCDMoveCursor(LCDDirectionType_e, uint8_t moveSize);
 		void LCDScroll(LCDDirectionType_e, uint8_t ScrollSize);
 		void LCDGOTO(LCDLineNumber_e  lineNo, uint8_t  col);
 		void LCDClearLine (LCDLineNumber_e lineNo);
+		uint16_t LCDWriteLine(LCDLineNumber_e lineNo, std::string_view text, LCDAlign_e align = LCDAlignLeft);
 		void LCDClearScreen(void);
 		void LCDClearScreenCmd(void);
 		void LCDHome(void);
 		void LCDChangeEntryMode(LCDEntryMode_e mode);
+		bool LCDIsReady(void);
+		bool LCDPoll(void);
+		void LCDBusyFlagModeSet(bool);
+		bool LCDBusyFlagModeGet(void);
+		int16_t LCDReadAddressCounter(void);
 		virtual size_t write(uint8_t);
+		virtual size_t write(const uint8_t *buffer, size_t size);
+		using Print::write;
+
+		/*!
+			@brief DDRAM address of a position for a given LCD size
+			@param rows Number of rows 1-4
+			@param cols Number of columns
+			@param line row 1-4
+			@param col column
+			@return DDRAM address
+			@details Rows 1 and 2 start at 0x00 and 0x40, rows 3 and 4 carry on from
+				the end of rows 1 and 2. A 16x01 runs as 8x02, columns 8-15 at 0x40.
+		*/
+		static constexpr uint8_t LCDCellAddress(uint8_t rows, uint8_t cols, uint8_t line, uint8_t col)
+		{
+			return (rows == 1 && cols == 16 && col >= 8) ? (0x40 + col - 8) :
+				(((line == 2 || line == 4) ? 0x40 : 0x00) + ((line >= 3) ? cols : 0) + col);
+		}
+
+		void LCDBufferModeSet(bool);
+		bool LCDBufferModeGet(void);
+		uint16_t LCDFlush(uint16_t maxBytes = UINT16_MAX);
+		bool LCDBufferDirtyGet(void);
+
+		void LCDI2CBatchSizeSet(uint8_t batchSize);
+		uint8_t LCDI2CBatchSizeGet(void);
+		size_t LCDEncode(const uint8_t *data, size_t length, bool isData, uint8_t *buffer);
+
+		uint16_t LCDAutoTuneClock(uint16_t maxKHz);
+		uint16_t LCDClockSpeedGet(void);
+
+		bool LCDAsyncInit(void);
+		bool LCDAsyncIRQInit(void);
+		void LCDAsyncDeInit(void);
+		bool LCDSendStringAsync(const char *str);
+		bool LCDSendStringAsync(const char *str, LCDLineNumber_e line, uint8_t col);
+		void LCDAsyncCallbackSet(void (*callback)(void));
+		bool LCDAsyncPoll(void);
+		void LCDWaitIdle(void);
+		bool LCDAsyncErrorGet(void);
+
+		bool LCDPIOModeGet(void);
+
+		bool LCDRecover(void);
+		bool LCDRecoverPendingGet(void);
+
+		void LCDDeferModeSet(bool);
+		bool LCDDeferModeGet(void);
+		void LCDDeferFlush(void);
+
+		static constexpr uint8_t LCDStatsBuckets = 16; /**< Latency histogram buckets */
+
+		/*! Bus counters, see LCDStatsGet */
+		struct LCDStats_t {
+			uint32_t transactions; /**< I2C write transactions */
+			uint32_t bytes; /**< PCF8574 port bytes written, 4 per character or command */
+			uint32_t characters; /**< Data bytes sent to LCD */
+			uint32_t commands; /**< Command bytes sent to LCD */
+			uint32_t nacks; /**< Transactions not acknowledged or aborted */
+			uint32_t timeouts; /**< Transactions timed out */
+			uint64_t busyTime; /**< Sum of blocking transaction times uS, for bus utilisation */
+			uint32_t retries; /**< Write attempts repeated after an error */
+			uint32_t recoveries; /**< Successful resyncs and restores by LCDRecover */
+			uint32_t recoveryTime; /**< Duration of the last successful LCDRecover uS */
+			uint32_t latency[LCDStatsBuckets]; /**< Blocking transactions by time, bucket n holds 2^n to 2^(n+1)-1 uS , first holds 0-1 and last all longer */
+		};
+
+		bool LCDStatsGet(LCDStats_t &snapshot);
+		void LCDStatsReset(void);
+
+		bool LCDTraceModeSet(bool);
+		bool LCDTraceModeGet(void);
+		size_t LCDTraceDump(void);
+		void LCDTraceClear(void);
+
+		/*!
+			@brief TX FIFO word for one byte of the PIO I2C master
+			@param byte Byte to send, the I2C address byte or a PCF8574 port byte
+			@param start true = START condition before the byte
+			@param stop true = STOP condition after the byte
+			@return word for the state machine, see HD44780_LCD_PCF8574_I2C.pio
+			@details Bits are inverted as the program pulls SDA low for a 1 in the word.
+		*/
+		static constexpr uint32_t LCDPIOEncode(uint8_t byte, bool start, bool stop)
+		{
+			return ((uint32_t)start << 31) | ((uint32_t)stop << 30) | ((uint32_t)(uint8_t)~byte << 22);
+		}
+
+	protected:
+
+		friend class HD44780LCDMarquee; // draws its region with LCDChangedRunEnd
+		friend class HD44780LCDScheduler; // counts only the address commands LCDGOTOAddress sends
+
+		bool LCDGOTOAddress(uint8_t address);
+		static uint8_t LCDChangedRunEnd(const bool *changed, const bool *follows, uint8_t start, uint8_t count);
 
 	private:
 
@@ -89,11 +223,7 @@ class HD44780LCD : public Print{
 	/*!  DDRAM address's used to set cursor position  Note Private */
 	enum LCDAddress_e : uint8_t {
 		LCDLineAddressOne =  0x80,  /**< Line 1 */
-		LCDLineAddressTwo =  0xC0, /**< Line 2 */
-		LCDLineAddress3Col20 = 0x94, /**< Line 3 20x04 line 3 */
-		LCDLineAddress4Col20 = 0xD4, /**< Line 4 20x04 line 4 */
-		LCDLineAddress3Col16  = 0x90, /**< Line 3 16x04  untested, no part */
-		LCDLineAddress4Col16  = 0xD0 /**< Line 4 16x04 untested, no part */
+		LCDLineAddressTwo =  0xC0 /**< Line 2 */
 	}; 
 
 	/*!  Command Bytes General  Note Private */
@@ -110,21 +240,177 @@ class HD44780LCD : public Print{
 		uint8_t _LCDSlaveAddresI2C;
 		uint8_t _NumRowsLCD = 2;
 		uint8_t _NumColsLCD = 16;
+		uint8_t _LCDRowAddress[4] = {0x00, 0x40, 0x10, 0x50}; /**< DDRAM address of column 0 of each row */
+		uint8_t _LCDSplitColumn = 16; /**< 8 on 16x01, columns from there on are at 0x40 , otherwise the column count */
 		uint8_t _SDataPin;
 		uint8_t _SClkPin;
 		uint16_t _CLKSpeed = 100; //I2C bus speed in khz datasheet says 100 for PCF8574 
 		i2c_inst_t *i2c; // i2C port number
 
+		// I2C batching, a run of characters is encoded into one buffer and sent in one transaction
+		static constexpr uint8_t _LCDI2CBatchMax = 32; /**< Max data bytes per I2C transaction */
+		uint8_t _LCDI2CBatchSize = _LCDI2CBatchMax; /**< Data bytes per I2C transaction */
+		uint8_t _LCDI2CBuffer[4 * _LCDI2CBatchMax]; /**< Encoded PCF8574 bytes, 4 per data byte */
+
+		// I2C clock tuning, see LCDAutoTuneClock
+		static constexpr uint16_t _LCDClockSteps[] = {100, 200, 300, 400, 500, 600, 800, 1000}; /**< Rates tried in KHz */
+		static constexpr uint8_t _LCDClockProbes = 16; /**< Port write/read backs per rate */
+		static constexpr uint8_t _LCDClockErrorLimit = 3; /**< Errors within _LCDClockErrorWindow that step rate down */
+		static constexpr uint32_t _LCDClockErrorWindow = 1000000; /**< Error count window uS */
+		uint16_t _LCDClockMinKHz = 0; /**< Lowest fall back rate , 0 = no runtime fall back */
+		uint8_t _LCDClockErrors = 0; /**< Write errors in current window */
+		absolute_time_t _LCDClockWindowStart{}; /**< Start of error count window */
+
+		// I2C error recovery, see LCDI2CWrite and LCDRecover
+		static constexpr uint8_t _LCDRetryMax = 3; /**< Write attempts per transaction, bus unstick before the last */
+		static constexpr uint32_t _LCDRetryBackoff = 100; /**< uS wait before first retry, doubles each retry */
+		bool _LCDRecoverPending = false; /**< Controller may be out of nibble sync or lost a write */
+		bool _LCDRecovering = false; /**< LCDRecover is replaying state */
+		bool _LCDRecoverFailed = false; /**< A write failed during LCDRecover */
+		uint8_t _LCDRecoverCount = 0; /**< Successful recoveries, lets a send see a restore happened under it */
+
+		// Async mode, encoded bytes queued in a ring buffer, drained by DMA or the TX empty interrupt into the I2C TX FIFO
+		enum LCDAsyncMode_e : uint8_t {
+			LCDAsyncOff = 0, /**< Writes block */
+			LCDAsyncDMA = 1, /**< DMA channel feeds the FIFO , see LCDAsyncInit */
+			LCDAsyncIRQ = 2  /**< I2C interrupt refills the FIFO , see LCDAsyncIRQInit */
+		};
+		static constexpr uint16_t _LCDAsyncRingSize = 256; /**< Ring size in encoded bytes, power of 2 */
+		static constexpr uint8_t _LCDAsyncFIFODepth = 16; /**< I2C TX FIFO entries */
+		LCDAsyncMode_e _LCDAsyncMode = LCDAsyncOff; /**< How the ring is drained */
+		int _LCDAsyncDMAChannel = -1; /**< DMA channel, -1 = none */
+		std::atomic<uint16_t> _LCDAsyncHead{0}; /**< Ring write count , written by the main loop */
+		std::atomic<uint16_t> _LCDAsyncTail{0}; /**< Ring read count , written by the interrupt in interrupt mode */
+		bool _LCDAsyncPending = false; /**< Data queued since last callback */
+		bool _LCDAsyncError = false; /**< Latched transfer abort */
+		void (*_LCDAsyncCallback)(void) = nullptr; /**< Called when queue is empty */
+		uint8_t _LCDAsyncRing[_LCDAsyncRingSize]; /**< Encoded PCF8574 bytes */
+		uint16_t _LCDAsyncDMABuffer[4 * _LCDI2CBatchMax]; /**< I2C data_cmd words for one transfer */
+		std::atomic<uint16_t> _LCDAsyncIRQBatch{0}; /**< Bytes sent since the last STOP , interrupt mode */
+		std::atomic<bool> _LCDAsyncIRQAbort{false}; /**< Abort latched by the interrupt , taken by LCDAsyncPoll */
+		static HD44780LCD *_LCDAsyncIRQOwner[2]; /**< LCD using the interrupt of each I2C block */
+
+		// PIO transport, a state machine is the I2C master fed by DMA , _LCDPIO == nullptr for I2C block
+		PIO _LCDPIO = nullptr; /**< PIO instance, nullptr = hardware I2C block */
+		uint _LCDPIOStateMachine = 0; /**< State machine running the I2C program */
+		uint _LCDPIOOffset = 0; /**< Program offset in PIO instruction memory */
+		bool _LCDPIOClaimed = false; /**< State machine claimed by LCDPIOBegin , released by LCDPIOEnd */
+		int _LCDPIODMAChannel = -1; /**< DMA channel feeding the TX FIFO , -1 = CPU feeds it */
+		absolute_time_t _LCDPIODoneAt{}; /**< Expected end of the transfer in progress */
+		uint32_t _LCDPIOBuffer[1 + 4 * _LCDI2CBatchMax]; /**< TX FIFO words, address + data */
+
+		// Deferred mode, commands are queued and folded before sending, see LCDDeferModeSet
+		static constexpr uint8_t _LCDDeferMax = 32; /**< Commands held before a forced fold and send */
+		bool _LCDDeferMode = false; /**< Queue commands instead of sending them */
+		uint8_t _LCDDeferCount = 0; /**< Commands in _LCDDeferQueue */
+		uint8_t _LCDDeferQueue[_LCDDeferMax]; /**< Address set, shift, display control and entry mode commands */
+
+		absolute_time_t _LCDBusyUntil{}; /**< Controller busy with last slow command until this time */
+		bool _LCDBusyFlagMode = false; /**< Poll busy flag instead of waiting fixed delays */
+		static constexpr uint8_t LCDBusyFlagMask = 0x80; /**< Busy flag bit in busy flag/address read */
+
+#if HD44780_LCD_STATS
+		LCDStats_t _LCDStats{}; /**< Bus counters */
+		spin_lock_t *_LCDStatsSpinLock = spin_lock_instance(next_striped_spin_lock_num()); /**< Guards _LCDStats across cores */
+#endif
+
+#if HD44780_LCD_TRACE
+		// Trace ring, records of time u32 , wait u16 , duration u16 , length u16 , flags u8 then the port bytes
+		static constexpr uint8_t _LCDTraceHeaderSize = 11; /**< Bytes before the port bytes of a record */
+		static constexpr uint8_t LCDTraceError = 0x01; /**< Record flag, transaction failed */
+		static constexpr uint8_t LCDTraceAsync = 0x02; /**< Record flag, queued for the DMA, time is when queued */
+		static constexpr uint8_t LCDTraceTruncated = 0x04; /**< Record flag, port bytes cut to fit the ring */
+		static constexpr uint8_t LCDTraceRead = 0x08; /**< Record flag, port read , bytes are the ones read */
+		bool _LCDTraceMode = false; /**< Record transactions */
+		uint8_t _LCDTraceRing[HD44780_LCD_TRACE_SIZE]; /**< Records, oldest dropped when full */
+		size_t _LCDTraceHead = 0; /**< Next byte written */
+		size_t _LCDTraceTail = 0; /**< First byte of oldest record */
+		size_t _LCDTraceUsed = 0; /**< Bytes in the ring */
+		uint32_t _LCDTraceDropped = 0; /**< Records dropped since the last dump */
+#endif
+
 		// ** DEBUG **  for serial debug I2C errors to console
 		bool _LCDSerialDebugFlag = false;
+		bool _LCDSharedBus = false; /**< Bus pins and interface are set up by their owner */
 
 		// Private internal enums
 
 		enum  LCDBackLight_e _LCDBackLight= LCDBackLightOnMask;  /**< Enum to store backlight status*/
-		
+		enum  LCDEntryMode_e _LCDEntryMode = LCDEntryModeThree; /**< Enum to store entry mode */
+		struct LCDEncodeTable_t {uint32_t word[2][2][256];}; /**< Encode table, indexed [backlight][rs][byte] */
+		static const LCDEncodeTable_t _LCDEncodeTable; /**< 4 PCF8574 port bytes per byte, one table shared by all instances */
+		static constexpr uint8_t LCDEntryIncrementBit = 0x02; /**< Entry mode I/D bit */
+		static constexpr uint8_t LCDEntryShiftBit = 0x01; /**< Entry mode S bit, display shifts on each write */
+
+		// Address counter tracking, used to skip redundant address commands
+		bool _LCDCursorKnown = false; /**< Address counter is known and points at DDRAM */
+		uint8_t _LCDCursorAddress = 0; /**< Tracked DDRAM address counter */
+		bool _LCDCursorRestore = false; /**< Counter moved to CGRAM, go back to _LCDCursorAddress before next write */
+
+		// Mode register and CGRAM tracking, replayed by LCDRecover
+		uint8_t _LCDDisplayControl = LCDDisplayOn; /**< Last display on/off and cursor command */
+		int8_t _LCDDisplayShift = 0; /**< Display shift from home, positive is right, -39 to 39 */
+		bool _LCDCGRAMMode = false; /**< Address counter points at CGRAM */
+		uint8_t _LCDCGRAMAddress = 0; /**< Tracked CGRAM address counter */
+		uint8_t _LCDCGRAMUsed = 0; /**< Bit per custom character written since power up */
+		uint8_t _LCDCGRAMShadow[64]; /**< Copy of CGRAM, 8 bytes per custom character */
+
+		static constexpr uint8_t _LCDPrintfMax = 80; /**< LCDPrintf characters, the whole DDRAM */
+
+		// Buffered mode, shadow copy of the 80 byte DDRAM
+		static constexpr uint8_t _LCDDDRAMSize = 80; /**< DDRAM size, 2 lines of 40 */
+		static constexpr uint8_t _LCDDDRAMLineSize = 40; /**< DDRAM characters per line */
+		bool _LCDBufferMode = false; /**< Writes go to frame buffer, LCDFlush sends them */
+		bool _LCDBufferDirty = false; /**< Frame buffer differs from shadow buffer */
+		bool _LCDShadowValid = false; /**< Shadow buffer matches the DDRAM of LCD */
+		uint8_t _LCDBufferAddress = 0; /**< DDRAM address of next buffered write */
+		uint8_t _LCDFrameBuffer[_LCDDDRAMSize]; /**< Content the user wants on screen */
+		uint8_t _LCDShadowBuffer[_LCDDDRAMSize]; /**< Content last sent to the LCD */
+
 		void LCDSendCmd (unsigned char cmd);
 		void LCDSendData (unsigned char data);
+		void LCDSendDataBuffer(const uint8_t *data, size_t length, uint8_t addressCmd = 0);
+		void LCDEncodeByte(uint8_t value, bool isData, uint8_t *buffer);
+		static constexpr LCDEncodeTable_t LCDEncodeTableMake(void);
+		bool LCDI2CWrite(const uint8_t *buffer, size_t length);
+		void LCDBusyFor(uint32_t delayUs);
+		void LCDWaitReady(void);
+		int16_t LCDReadBusyAddress(void);
+		int LCDI2CTransfer(uint8_t *buffer, size_t length, bool read);
+		bool LCDAsyncQueue(const uint8_t *data, size_t length, uint8_t addressCmd);
+		void LCDPutChar(uint8_t data);
+		void LCDTrackCmd(uint8_t cmd);
+		void LCDTrackData(size_t count);
+		void LCDMirrorData(const uint8_t *data, size_t length);
+		bool LCDI2CWriteAttempts(const uint8_t *buffer, size_t length);
+		void LCDBusUnstick(void);
+		uint8_t LCDCellAddressCmd(LCDLineNumber_e line, uint8_t col);
+		void LCDBufferClear(void);
+		uint8_t LCDAddressStep(uint8_t address, bool increment);
+		int8_t LCDAddressToIndex(uint8_t address);
+		uint8_t LCDIndexToAddress(uint8_t index);
 		bool LCD_I2C_ON(void);
+		bool LCDClockProbe(void);
+#if HD44780_LCD_STATS
+		void LCDStatsTransaction(size_t length, uint64_t startTime, int returnCode);
+		uint32_t LCDStatsLock(void);
+		void LCDStatsUnlock(uint32_t interrupts);
+#endif
+#if HD44780_LCD_TRACE
+		void LCDTraceRecord(const uint8_t *buffer, size_t length, uint64_t waitStart, uint64_t writeStart, uint8_t flags);
+		void LCDTracePut(const uint8_t *bytes, size_t length);
+#endif
+		void LCDClockFallback(void);
+		bool LCDPIOBegin(void);
+		void LCDPIOEnd(void);
+		bool LCDPIOWrite(const uint8_t *buffer, size_t length);
+		bool LCDPIOWaitIdle(void);
+		bool LCDAsyncIRQPoll(void);
+		void LCDAsyncIRQService(void);
+		static void LCDAsyncIRQHandler0(void);
+		static void LCDAsyncIRQHandler1(void);
+		bool LCDDeferQueue(uint8_t cmd);
+		uint16_t LCDDeferEmit(bool addressDead, bool shiftDead);
 
 	}; // end of HD44780LCD class
 
@@ -0,0 +1,177 @@
+/*!
+	@file     HD44780_LCD_PCF8574_Coro.hpp
+	@author   Gavin Lyons
+	@brief    C++20 coroutine API for HD44780 LCD, awaitable LCD operations run by a polled executor
+*/
+
+#ifndef LCD_HD44780_CORO_H
+#define LCD_HD44780_CORO_H
+
+#include <coroutine>
+#include <exception>
+#include <string_view>
+#include "HD44780_LCD_PCF8574.hpp"
+
+class HD44780LCDAwaiter;
+class HD44780LCDExecutor;
+
+/*!
+	@brief Coroutine type of an LCD task, a function returning it may use co_await
+	@details The task starts suspended and runs once spawned on an executor, which owns it from then on.
+*/
+class HD44780LCDTask {
+	public:
+		/*! Coroutine state kept by the compiler in the task frame */
+		struct promise_type {
+			HD44780LCDExecutor *executor = nullptr; /**< Executor the task was spawned on */
+			HD44780LCDAwaiter *waiting = nullptr; /**< Awaiter the task is suspended on , nullptr = ready to run */
+
+			HD44780LCDTask get_return_object(void) {
+				return HD44780LCDTask(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+			std::suspend_always initial_suspend(void) noexcept {return {};}
+			std::suspend_always final_suspend(void) noexcept {return {};}
+			void return_void(void) {}
+			void unhandled_exception(void) {std::terminate();}
+		};
+
+		HD44780LCDTask(HD44780LCDTask &&other) noexcept : _handle(other._handle) {other._handle = nullptr;}
+		HD44780LCDTask(const HD44780LCDTask &) = delete;
+		HD44780LCDTask &operator=(const HD44780LCDTask &) = delete;
+		~HD44780LCDTask() {if (_handle) {_handle.destroy();}}
+
+	private:
+		friend class HD44780LCDExecutor;
+		explicit HD44780LCDTask(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+		std::coroutine_handle<promise_type> _handle;
+};
+
+/*!
+	@brief Single threaded executor for LCD tasks, polled from the main loop
+	@details Each LCDExecutorPoll steps the operation every suspended task waits on,
+		without blocking, and resumes the tasks whose operation finished.
+		Tasks run one at a time, so LCD calls of two tasks never overlap.
+	@note Task frames come from the heap when the task function is called,
+		spawn long lived tasks at start up.
+*/
+class HD44780LCDExecutor {
+	public:
+		HD44780LCDExecutor(){};
+		~HD44780LCDExecutor();
+
+		bool LCDExecutorSpawn(HD44780LCDTask &&task);
+		uint8_t LCDExecutorPoll(uint64_t nowUs);
+		uint8_t LCDExecutorCountGet(void);
+		uint64_t LCDExecutorNowGet(void);
+
+		static constexpr uint8_t LCDExecutorMaxTasks = 8; /**< Tasks per executor */
+
+	private:
+		std::coroutine_handle<HD44780LCDTask::promise_type> _tasks[LCDExecutorMaxTasks]{};
+		uint8_t _count = 0;
+		uint64_t _nowUs = 0; /**< Time passed to the running or last poll */
+};
+
+/*!
+	@brief Base of the awaitable LCD operations
+	@details co_await runs the first step at once, the task only suspends if the
+		operation is not finished. The executor then calls LCDAwaitStep on each poll.
+*/
+class HD44780LCDAwaiter {
+	public:
+		bool await_ready(void) {return false;}
+		bool await_suspend(std::coroutine_handle<HD44780LCDTask::promise_type> handle)
+		{
+			if (LCDAwaitStep(handle.promise().executor->LCDExecutorNowGet()) == true) {return false;}
+			handle.promise().waiting = this;
+			return true;
+		}
+		void await_resume(void) {}
+
+		/*!
+			@brief Do the part of the operation that does not block
+			@param nowUs Time of the poll in uS
+			@return true when the operation is finished
+		*/
+		virtual bool LCDAwaitStep(uint64_t nowUs) = 0;
+
+	protected:
+		~HD44780LCDAwaiter() = default;
+};
+
+/*!
+	@brief Awaitable operations on one LCD, for use inside an HD44780LCDTask
+	@details Operations wait without blocking while the controller is busy with a slow
+		command and while async DMA transfers are in flight, see LCDPoll.
+		@code
+		HD44780LCDTask ui(HD44780LCDAwait &lcd)
+		{
+			co_await lcd.clear();
+			co_await lcd.writeLine(HD44780LCD::LCDLineNumberOne, "Hello");
+			co_await lcd.delay(500000);
+		}
+		@endcode
+*/
+class HD44780LCDAwait {
+	public:
+		HD44780LCDAwait(HD44780LCD &lcd) : _lcd(lcd) {}
+		~HD44780LCDAwait(){};
+
+		/*! Awaitable clear screen, waits out the clear command */
+		class LCDClearAwaiter final : public HD44780LCDAwaiter {
+			public:
+				LCDClearAwaiter(HD44780LCD &lcd) : _lcd(lcd) {}
+				bool LCDAwaitStep(uint64_t nowUs) override;
+			private:
+				HD44780LCD &_lcd;
+				bool _sent = false;
+		};
+
+		/*! Awaitable buffered mode flush, at most _maxBytes on the bus per step */
+		class LCDFlushAwaiter : public HD44780LCDAwaiter {
+			public:
+				LCDFlushAwaiter(HD44780LCD &lcd, uint16_t maxBytes) : _lcd(lcd), _maxBytes(maxBytes) {}
+				bool LCDAwaitStep(uint64_t nowUs) override;
+			protected:
+				HD44780LCD &_lcd;
+				uint16_t _maxBytes;
+		};
+
+		/*! Awaitable row write, flushed in steps in buffered mode */
+		class LCDWriteLineAwaiter final : public LCDFlushAwaiter {
+			public:
+				LCDWriteLineAwaiter(HD44780LCD &lcd, HD44780LCD::LCDLineNumber_e line, std::string_view text,
+					HD44780LCD::LCDAlign_e align, uint16_t maxBytes)
+					: LCDFlushAwaiter(lcd, maxBytes), _line(line), _text(text), _align(align) {}
+				bool LCDAwaitStep(uint64_t nowUs) override;
+			private:
+				HD44780LCD::LCDLineNumber_e _line;
+				std::string_view _text;
+				HD44780LCD::LCDAlign_e _align;
+				bool _written = false;
+		};
+
+		/*! Awaitable wait for a time */
+		class LCDDelayAwaiter final : public HD44780LCDAwaiter {
+			public:
+				LCDDelayAwaiter(uint32_t delayUs) : _delayUs(delayUs) {}
+				bool LCDAwaitStep(uint64_t nowUs) override;
+			private:
+				uint32_t _delayUs;
+				bool _started = false;
+				uint64_t _untilUs = 0; /**< Set by the first step */
+		};
+
+		LCDClearAwaiter clear(void);
+		LCDWriteLineAwaiter writeLine(HD44780LCD::LCDLineNumber_e line, std::string_view text,
+			HD44780LCD::LCDAlign_e align = HD44780LCD::LCDAlignLeft, uint16_t maxBytes = LCDAwaitFlushBytes);
+		LCDFlushAwaiter flush(uint16_t maxBytes = LCDAwaitFlushBytes);
+		LCDDelayAwaiter delay(uint32_t delayUs);
+
+		static constexpr uint16_t LCDAwaitFlushBytes = 64; /**< Default bus bytes per flush step, 16 characters */
+
+	private:
+		HD44780LCD &_lcd;
+};
+
+#endif // guard header ending
@@ -0,0 +1,83 @@
+/*!
+	@file     HD44780_LCD_PCF8574_Geometry.hpp
+	@author   Gavin Lyons
+	@brief    Compile time LCD size front end for HD44780LCD class
+*/
+
+#ifndef LCD_HD44780_GEOMETRY_H
+#define LCD_HD44780_GEOMETRY_H
+
+#include "HD44780_LCD_PCF8574.hpp"
+
+/*!
+	@brief HD44780 LCD with rows and columns fixed at compile time
+	@tparam Rows number of rows 1-4
+	@tparam Cols number of columns , 8 to 40
+	@details Row addresses come from a constexpr table and positions known at compile
+		time are checked with static_assert, e.g. LCDGOTO<LCDLineNumberTwo, 5>().
+		Covers 8x1, 16x1, 16x2, 16x4, 20x2, 20x4, 24x2, 40x2 and other sizes a single controller can drive.
+	@note The runtime HD44780LCD::LCDInit(cursor, rows, cols) path is unchanged.
+*/
+template <uint8_t Rows, uint8_t Cols>
+class HD44780LCDGeometry : public HD44780LCD {
+	static_assert(Rows >= 1 && Rows <= 4, "HD44780 supports 1 to 4 rows");
+	static_assert(Cols >= 8 && Cols <= 40, "HD44780 supports 8 to 40 columns");
+	static_assert(Rows * Cols <= 80, "HD44780 DDRAM holds 80 characters");
+	static_assert(Rows <= 2 || Cols <= 20, "4 row LCD over 20 columns needs two controllers");
+
+	public:
+		using HD44780LCD::HD44780LCD;
+
+		static constexpr uint8_t NumRows = Rows; /**< Rows on display */
+		static constexpr uint8_t NumCols = Cols; /**< Columns on display */
+		static constexpr uint8_t NumCells = Rows * Cols; /**< Characters on display */
+
+		/*!
+			@brief Initialise LCD with the compile time size
+			@param cursorType The cursor type 4 choices.
+			@return true for success , false for failure to init I2C
+		*/
+		bool LCDInit(LCDCursorType_e cursorType)
+		{
+			return HD44780LCD::LCDInit(cursorType, Rows, Cols);
+		}
+
+		/*!
+			@brief DDRAM address of a position, constant folded when arguments are constant
+			@param line row 1-4
+			@param col column
+			@return DDRAM address
+		*/
+		static constexpr uint8_t LCDAddress(uint8_t line, uint8_t col)
+		{
+			return LCDCellAddress(Rows, Cols, line, col);
+		}
+
+		/*!
+			@brief moves cursor to a position checked at compile time
+			@tparam Line row 1-4
+			@tparam Col column
+		*/
+		template <LCDLineNumber_e Line, uint8_t Col>
+		void LCDGOTO(void)
+		{
+			static_assert(Line >= LCDLineNumberOne && Line <= Rows, "row is not on this LCD");
+			static_assert(Col < Cols, "column is not on this LCD");
+			constexpr uint8_t address = LCDAddress(Line, Col);
+			LCDGOTOAddress(address);
+		}
+
+		/*!
+			@brief moves cursor to a position, no geometry branches
+			@param line row 1-4
+			@param col column
+			@note A row not on this LCD is ignored, as in HD44780LCD::LCDGOTO.
+		*/
+		void LCDGOTO(LCDLineNumber_e line, uint8_t col)
+		{
+			if (line < LCDLineNumberOne || line > Rows) {return;}
+			LCDGOTOAddress(LCDAddress(line, col));
+		}
+};
+
+#endif // guard header ending
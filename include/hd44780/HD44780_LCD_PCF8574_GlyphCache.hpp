@@ -0,0 +1,49 @@
+/*!
+	@file     HD44780_LCD_PCF8574_GlyphCache.hpp
+	@author   Gavin Lyons
+	@brief    CGRAM glyph cache for HD44780 LCD, more than 8 custom characters
+*/
+
+#ifndef LCD_HD44780_GLYPHCACHE_H
+#define LCD_HD44780_GLYPHCACHE_H
+
+#include "HD44780_LCD_PCF8574.hpp"
+
+/*!
+	@brief Class to share the 8 CGRAM slots between any number of custom characters
+	@details A glyph is identified by the content of its 8 byte bitmap. The cache tracks
+		which bitmaps are resident, treats identical bitmaps as one glyph and on a miss
+		replaces the least recently used glyph that is not visible on screen.
+		CGRAM is only written on a miss.
+	@note Visibility is read from the shadow copy of DDRAM and, in buffered mode, the frame
+		buffer too, so a glyph still shown until the next LCDFlush is not replaced.
+		While the screen content is unknown or the display is shifted no slot is replaced.
+*/
+class HD44780LCDGlyphCache {
+	public:
+		HD44780LCDGlyphCache(HD44780LCD &lcd);
+		~HD44780LCDGlyphCache(){};
+
+		int8_t LCDGlyphAcquire(const uint8_t *bitmap);
+		bool LCDGlyphPrint(const uint8_t *bitmap);
+		void LCDGlyphReset(void);
+		uint32_t LCDGlyphUploadsGet(void);
+
+	private:
+
+		static constexpr uint8_t _LCDGlyphSlots = 8; /**< CGRAM slots on HD44780 */
+
+		/*! One CGRAM slot */
+		struct LCDGlyphSlot_t {
+			const uint8_t *id; /**< Bitmap pointer last acquired for this slot , nullptr = empty */
+			uint8_t bitmap[8]; /**< Copy of bitmap in CGRAM */
+			uint32_t lastUse; /**< Value of _useCounter at last acquire */
+		};
+
+		HD44780LCD &_lcd;
+		LCDGlyphSlot_t _slots[_LCDGlyphSlots];
+		uint32_t _useCounter = 0;
+		uint32_t _uploads = 0;
+};
+
+#endif // guard header ending
@@ -0,0 +1,62 @@
+/*!
+	@file     HD44780_LCD_PCF8574_Manager.hpp
+	@author   Gavin Lyons
+	@brief    Manager for several HD44780 LCDs with PCF8574 backpacks on one I2C bus
+*/
+
+#ifndef LCD_HD44780_MANAGER_H
+#define LCD_HD44780_MANAGER_H
+
+#include "HD44780_LCD_PCF8574.hpp"
+
+/*!
+	@brief Class to own one I2C bus and share it between up to 8 LCDs
+	@details The manager sets up the pins and I2C interface once, the displays
+		skip that part of LCDInit. Displays run in buffered mode and LCDManagerFrame
+		flushes them round robin within a byte budget, so one busy display can not
+		starve the others.
+*/
+class HD44780LCDManager {
+	public:
+		HD44780LCDManager(i2c_inst_t* i2c_type, uint16_t CLKspeed, uint8_t SDApin, uint8_t SCLKpin);
+		~HD44780LCDManager(){};
+
+		bool LCDManagerBegin(void);
+		void LCDManagerEnd(void);
+		int8_t LCDManagerAdd(HD44780LCD &lcd);
+		uint8_t LCDManagerCountGet(void);
+		HD44780LCD *LCDManagerDisplayGet(uint8_t index);
+
+		uint16_t LCDManagerFrame(uint16_t budgetBytes);
+		uint32_t LCDManagerFramesGet(void);
+		uint32_t LCDManagerFramesGet(uint8_t index);
+		uint16_t LCDManagerFPSGet(void);
+
+		static constexpr uint8_t LCDManagerMaxDisplays = 8; /**< PCF8574 addresses 0x20-0x27 */
+
+	private:
+
+		/*! Per display state */
+		struct LCDManagerDisplay_t {
+			HD44780LCD *lcd; /**< The display */
+			uint32_t frames; /**< Frames completely sent */
+		};
+
+		static constexpr uint16_t _LCDManagerMinBytes = 8; /**< Smallest useful flush, address + 1 character */
+		static constexpr uint32_t _LCDManagerFPSWindow = 1000000; /**< uS between FPS updates */
+
+		i2c_inst_t *_i2c;
+		uint16_t _CLKSpeed;
+		uint8_t _SDataPin;
+		uint8_t _SClkPin;
+
+		LCDManagerDisplay_t _displays[LCDManagerMaxDisplays];
+		uint8_t _count = 0;
+		uint8_t _next = 0; /**< Display served first on the next frame */
+		uint32_t _frames = 0; /**< Display frames sent, all displays */
+		uint32_t _windowFrames = 0; /**< _frames at start of FPS window */
+		uint64_t _windowStart = 0; /**< Start of FPS window, uS */
+		uint16_t _fps = 0; /**< Display frames per second, all displays */
+};
+
+#endif // guard header ending
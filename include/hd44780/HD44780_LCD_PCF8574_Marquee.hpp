@@ -0,0 +1,58 @@
+/*!
+	@file     HD44780_LCD_PCF8574_Marquee.hpp
+	@author   Gavin Lyons
+	@brief    Marquee for HD44780 LCD, scrolls text longer than a row or region
+*/
+
+#ifndef LCD_HD44780_MARQUEE_H
+#define LCD_HD44780_MARQUEE_H
+
+#include "HD44780_LCD_PCF8574.hpp"
+
+/*!
+	@brief Class to scroll a string through a row or part of a row at a fixed rate
+	@details The text loops with _LCDMarqueeGap spaces between its end and its restart.
+		Two ways to move it, picked by LCDMarqueeBegin :
+		-# Display shift : the text is written once into the 40 DDRAM columns of the line
+			and each step is one shift command. Used when the caller lets the whole display
+			move, the region is a full row of a 1 or 2 row LCD and the text fits in 40 columns.
+		-# Window : each step works out the visible window over the text ring and
+			writes only the cells that changed since the last step.
+	@note The text is not copied, it must stay valid until LCDMarqueeStop.
+		The cursor is left at the last cell written, entry mode must be increment.
+*/
+class HD44780LCDMarquee {
+	public:
+		HD44780LCDMarquee(HD44780LCD &lcd);
+		~HD44780LCDMarquee(){};
+
+		bool LCDMarqueeBegin(const char *text, HD44780LCD::LCDLineNumber_e line, uint8_t col,
+			uint8_t width, uint32_t stepUs, bool displayShift = false);
+		void LCDMarqueeStop(void);
+		bool LCDMarqueeTick(uint64_t nowUs);
+		bool LCDMarqueeDisplayShiftGet(void);
+
+	private:
+
+		static constexpr uint8_t _LCDMarqueeGap = 3; /**< Spaces between the end of the text and its restart */
+		static constexpr uint8_t _LCDMarqueeMaxWidth = 40; /**< DDRAM columns per line */
+
+		void LCDMarqueeDraw(void);
+		uint8_t LCDMarqueeRingChar(size_t index);
+
+		HD44780LCD &_lcd;
+		const char *_text = nullptr; /**< Text to scroll , nullptr = stopped */
+		size_t _textLength = 0;
+		size_t _ringLength = 0; /**< Text plus gap, steps before the text repeats */
+		size_t _position = 0; /**< Ring index shown in the first cell of the region */
+		HD44780LCD::LCDLineNumber_e _line = HD44780LCD::LCDLineNumberOne;
+		uint8_t _col = 0;
+		uint8_t _width = 0;
+		uint32_t _stepUs = 0;
+		uint64_t _nextStepUs = 0; /**< Time of next step , 0 = set on first tick */
+		bool _displayShift = false; /**< true = hardware display shift , false = window */
+		bool _windowValid = false; /**< _window holds what is on screen */
+		uint8_t _window[_LCDMarqueeMaxWidth]; /**< Region content last written */
+};
+
+#endif // guard header ending
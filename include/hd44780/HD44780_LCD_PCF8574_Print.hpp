@@ -22,7 +22,15 @@
 #include <inttypes.h>
 #include <stdio.h> // for size_t
 #include <string.h>
+#include <string_view>
+#include <span>
+
+#ifndef HD44780_LCD_STD_STRING
+#define HD44780_LCD_STD_STRING 1 // 0 = no std::string overloads, keeps libstdc++ string code out of the image
+#endif
+#if HD44780_LCD_STD_STRING
 #include <string>
+#endif
 
 class Print
 {
@@ -50,6 +58,9 @@ class Print
 		size_t write(const char *buffer, size_t size) {
 			return write((const uint8_t *)buffer, size);
 		}
+		size_t write(std::span<const uint8_t> buffer) {
+			return write(buffer.data(), buffer.size());
+		}
 
 		// default to zero, meaning "a single write may block"
 		// should be overriden by subclasses with buffering
@@ -62,7 +73,11 @@ class Print
 		size_t print(long, int = DEC);
 		size_t print(unsigned long, int = DEC);
 		size_t print(double, int = 2);
+#if HD44780_LCD_STD_STRING
 		size_t print(const std::string &);
+#endif
+		size_t print(std::string_view);
+		size_t printFixed(int32_t value, uint8_t scale);
 
 		size_t println(const char[]);
 		size_t println(char);
@@ -72,15 +87,23 @@ class Print
 		size_t println(unsigned long, int = DEC);
 		size_t println(double, int = 2);
 		size_t println(void);
+#if HD44780_LCD_STD_STRING
 		size_t println(const std::string &s);
+#endif
+		size_t println(std::string_view);
+		size_t printlnFixed(int32_t value, uint8_t scale);
 
 	protected:
 		void setWriteError(int err = 1) { write_error = err; }
 
 	private:
 		int write_error;
+		static const uint32_t powersOfTen[10];
+		static char *formatNumber(char *end, unsigned long n, uint8_t base);
+		static char *formatFraction(char *end, uint32_t fraction, uint8_t digits);
 		size_t printNumber(unsigned long, uint8_t);
 		size_t printFloat(double, uint8_t);
+		size_t printFloatDigits(double, uint8_t);
 
 
 };
@@ -0,0 +1,69 @@
+/*!
+	@file     HD44780_LCD_PCF8574_Scheduler.hpp
+	@author   Gavin Lyons
+	@brief    Refresh scheduler for HD44780 LCD, rate limited screen regions with priorities
+*/
+
+#ifndef LCD_HD44780_SCHEDULER_H
+#define LCD_HD44780_SCHEDULER_H
+
+#include "HD44780_LCD_PCF8574.hpp"
+
+/*!
+	@brief Class to refresh regions of the screen by priority within a byte budget
+	@details Each region is a run of cells on one row with a minimum time between
+		refreshes and a priority. LCDSchedulerWrite only stores the text, a later write
+		before the refresh replaces it. LCDSchedulerTick sends dirty regions whose
+		interval has passed, highest priority first, until the byte budget is used.
+		A region that does not fit is sent in part and finished on the next tick.
+		Priority rises by one for each _LCDSchedulerAgeUs a region waits, so low
+		priority regions are not starved.
+	@note A region whose cost fits the budget is sent on the next tick when no region
+		of higher priority is waiting. Use with buffered mode off, the budget counts
+		bytes written on the I2C bus, 4 per character or command.
+*/
+class HD44780LCDScheduler {
+	public:
+		HD44780LCDScheduler(HD44780LCD &lcd);
+		~HD44780LCDScheduler(){};
+
+		int8_t LCDSchedulerAdd(HD44780LCD::LCDLineNumber_e line, uint8_t col, uint8_t width,
+			uint32_t minIntervalUs, uint8_t priority);
+		bool LCDSchedulerWrite(uint8_t region, const char *text);
+		uint16_t LCDSchedulerTick(uint64_t nowUs, uint16_t budgetBytes);
+		bool LCDSchedulerDirtyGet(uint8_t region);
+		uint8_t LCDSchedulerCountGet(void);
+
+		static constexpr uint8_t LCDSchedulerMaxRegions = 16; /**< Regions per scheduler */
+
+	private:
+
+		static constexpr uint8_t _LCDSchedulerMaxWidth = 40; /**< DDRAM columns per line */
+		static constexpr uint8_t _LCDSchedulerMinBytes = 8; /**< Smallest useful write, address + 1 character */
+		static constexpr uint32_t _LCDSchedulerAgeUs = 50000; /**< Wait that raises priority by one */
+
+		/*! Per region state */
+		struct LCDSchedulerRegion_t {
+			HD44780LCD::LCDLineNumber_e line;
+			uint8_t col;
+			uint8_t width;
+			uint8_t priority; /**< Higher is sent first */
+			uint32_t minIntervalUs; /**< Least time between refreshes */
+			uint64_t lastRefreshUs; /**< Time the last refresh was completed */
+			uint64_t dirtySinceUs; /**< Tick time of the first write not yet sent */
+			bool dirty; /**< pending differs from shown */
+			bool refreshed; /**< Sent at least once , lastRefreshUs is valid */
+			uint8_t pending[_LCDSchedulerMaxWidth]; /**< Latest text written */
+			uint8_t shown[_LCDSchedulerMaxWidth]; /**< Text on screen */
+		};
+
+		uint16_t LCDSchedulerPriority(const LCDSchedulerRegion_t &region, uint64_t nowUs);
+		uint16_t LCDSchedulerSend(LCDSchedulerRegion_t &region, uint64_t nowUs, uint16_t maxBytes);
+
+		HD44780LCD &_lcd;
+		LCDSchedulerRegion_t _regions[LCDSchedulerMaxRegions];
+		uint8_t _count = 0;
+		uint64_t _tickUs = 0; /**< Time of the last tick */
+};
+
+#endif // guard header ending
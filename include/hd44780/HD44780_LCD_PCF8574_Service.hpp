@@ -0,0 +1,87 @@
+/*!
+	@file     HD44780_LCD_PCF8574_Service.hpp
+	@author   Gavin Lyons
+	@brief    Display service for HD44780 LCD, runs the LCD on core1 fed by a lock-free command ring.
+*/
+
+#ifndef LCD_HD44780_SERVICE_H
+#define LCD_HD44780_SERVICE_H
+
+#include <atomic>
+#include "HD44780_LCD_PCF8574.hpp"
+
+/*!
+	@brief Class for a HD44780 display service, producer on one core and consumer on the other
+	@details Core0 pushes compact commands into a single-producer/single-consumer ring,
+		core1 calls LCDServiceRun (or LCDServiceProcess) and does the I2C work.
+		Producer methods are wait-free and never block on the LCD or the bus.
+*/
+class HD44780LCDService {
+	public:
+
+		/*! Ring overflow policy */
+		enum LCDServiceOverflow_e : uint8_t {
+			LCDServiceDropNewest = 0, /**< Full ring rejects new commands */
+			LCDServiceDropOldest = 1  /**< New commands overwrite the oldest unread commands */
+		};
+
+		HD44780LCDService(HD44780LCD &lcd, LCDServiceOverflow_e overflow = LCDServiceDropOldest);
+		~HD44780LCDService(){};
+
+		// Producer side , core0
+		bool LCDServiceGOTO(HD44780LCD::LCDLineNumber_e line, uint8_t col);
+		bool LCDServiceText(const char *str);
+		bool LCDServiceCreateCustomChar(uint8_t location, const uint8_t *charmap);
+		bool LCDServicePrintCustomChar(uint8_t location);
+		bool LCDServiceBackLight(bool OnOff);
+		bool LCDServiceClear(void);
+		uint32_t LCDServiceDroppedGet(void);
+
+		// Consumer side , core1
+		bool LCDServiceProcess(void);
+		void LCDServiceRun(void);
+
+	private:
+
+		/*! Command types held in the ring */
+		enum LCDServiceCmd_e : uint8_t {
+			LCDServiceCmdGOTO = 0,
+			LCDServiceCmdText = 1,
+			LCDServiceCmdCreateChar = 2,
+			LCDServiceCmdPrintChar = 3,
+			LCDServiceCmdBackLight = 4,
+			LCDServiceCmdClear = 5
+		};
+
+		static constexpr uint8_t _LCDServiceTextMax = 20; /**< Max characters per text command */
+		static constexpr uint8_t _LCDServiceWords = 6; /**< Command size in 32 bit words */
+		static constexpr uint32_t _LCDServiceRingSize = 32; /**< Slots in ring, power of 2 */
+
+		/*! One command, 24 bytes */
+		struct LCDServiceCommand_t {
+			uint8_t type;
+			uint8_t arg1;
+			uint8_t arg2;
+			uint8_t length;
+			uint8_t data[_LCDServiceTextMax];
+		};
+
+		/*! Ring slot, seq is odd while the producer writes it and 2*(index+1) once published */
+		struct LCDServiceSlot_t {
+			std::atomic<uint32_t> seq{0};
+			std::atomic<uint32_t> words[_LCDServiceWords];
+		};
+
+		HD44780LCD &_lcd;
+		LCDServiceOverflow_e _overflow;
+		LCDServiceSlot_t _ring[_LCDServiceRingSize];
+		std::atomic<uint32_t> _head{0}; /**< Commands pushed, written by producer */
+		std::atomic<uint32_t> _tail{0}; /**< Commands consumed, written by consumer */
+		std::atomic<uint32_t> _producerDrops{0}; /**< Commands rejected when full */
+		std::atomic<uint32_t> _consumerDrops{0}; /**< Commands overwritten before read */
+
+		bool LCDServicePush(const LCDServiceCommand_t &command);
+		void LCDServiceExecute(const LCDServiceCommand_t &command);
+};
+
+#endif // guard header ending
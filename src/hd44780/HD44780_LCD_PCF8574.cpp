@@ -1,9 +1,12 @@
 
 
 // Section : Includes
-#include <stdio.h> // optional for printf debug messages
+#include <stdio.h> // printf debug messages, vsnprintf for LCDPrintf
+#include <stdarg.h>
+#include <string.h>
 #include "pico/stdlib.h"
 #include "../../include/hd44780/HD44780_LCD_PCF8574.hpp"
+#include "HD44780_LCD_PCF8574_I2C.pio.h"
 
 /*!
 	@brief Constructor for class HD44780LCD
@@ -22,6 +25,40 @@ HD44780LCD  :: HD44780LCD(uint8_t I2Caddress, i2c_inst_t* i2c_type, uint16_t CLK
 	_CLKSpeed = CLKspeed;
 }
 
+/*!
+	@brief Constructor for class HD44780LCD using a PIO state machine as I2C master
+	@param I2Caddress  The PCF8574 I2C address, default is 0x27.
+	@param pio PIO instance pio0 or pio1
+	@param sm State machine 0-3 , claimed in LCDInit
+	@param CLKspeed I2C Bus Clock speed in KHz, up to about 1/32 of system clock
+	@param SDApin I2C Data pin
+	@param SCLKpin I2C Clock pin , must be SDApin + 1
+	@note Same API as the I2C block version. Transfers are fed to the state machine
+		by DMA so the CPU is free while they run. Write only, busy flag mode
+		and async mode are not available.
+*/
+HD44780LCD  :: HD44780LCD(uint8_t I2Caddress, PIO pio, uint sm, uint16_t CLKspeed, uint8_t  SDApin, uint8_t  SCLKpin)
+{
+	_LCDSlaveAddresI2C  = I2Caddress;
+	i2c = nullptr;
+	_LCDPIO = pio;
+	_LCDPIOStateMachine = sm;
+	_SClkPin = SCLKpin;
+	_SDataPin = SDApin;
+	_CLKSpeed = CLKspeed;
+}
+
+/*!
+	@brief Destructor for class HD44780LCD, releases the DMA channel or I2C interrupt of async mode
+		and the PIO state machine, program and DMA channel of the PIO transport
+	@note Pins and the I2C block are left alone, call LCDDeInit for those.
+*/
+HD44780LCD  :: ~HD44780LCD()
+{
+	LCDAsyncDeInit();
+	if (_LCDPIO != nullptr) {LCDPIOEnd();}
+}
+
 
 // Section : Methods
 /*!
@@ -29,66 +66,685 @@ HD44780LCD  :: HD44780LCD(uint8_t I2Caddress, i2c_inst_t* i2c_type, uint16_t CLK
 	@param data The data byte to send
 	@note if _LCDSerialDebugFlag is true, will output data on I2C failures.
 */
-void HD44780LCD::LCDSendData(unsigned char data) {
-		// I2C MASK Byte = DATA-led-en-rw-rs (en=enable rs = reg select)(rw always write)
+void __not_in_flash_func(HD44780LCD::LCDSendData)(unsigned char data) {
+	LCDSendDataBuffer(&data, 1);
+}
+
+/*!
+	@brief  Send command byte to  lcd
+	@param cmd command byte
+	@note if _LCDSerialDebugFlag == true  ,will output data on I2C failures.
+*/
+void __not_in_flash_func(HD44780LCD::LCDSendCmd)(unsigned char cmd) {
+	uint8_t cmdBufferI2C[4];
+
+	if (_LCDDeferMode == true && _LCDRecovering == false && LCDDeferQueue(cmd) == true)
+	{
+		LCDTrackCmd(cmd); // tracked state is the state after the queue is sent
+		return;
+	}
+	LCDEncodeByte(cmd, false, cmdBufferI2C);
+	LCDTrackCmd(cmd); // before the write, so a recovery during it replays this command
+	LCDI2CWrite(cmdBufferI2C, 4);
+}
+
+/*!
+	@brief  Send a run of data bytes to LCD, batched into as few I2C transactions as possible
+	@param data Pointer to the data bytes
+	@param length Number of data bytes
+	@param addressCmd Optional command byte sent ahead of the data in the same transaction, 0 for none.
+	@note Each transaction holds at most _LCDI2CBatchSize bytes including the command, see LCDI2CBatchSizeSet.
+		If a recovery runs during the send it restores the whole run from the shadow copies, so the rest is dropped.
+*/
+void __not_in_flash_func(HD44780LCD::LCDSendDataBuffer)(const uint8_t *data, size_t length, uint8_t addressCmd) {
+	uint8_t *nextByte = _LCDI2CBuffer;
+	uint8_t recoverCount = _LCDRecoverCount;
+
+	if (_LCDDeferCount > 0) {LCDDeferEmit(addressCmd != 0, false);}
+	if (addressCmd == 0 && _LCDCursorRestore == true) {
+		addressCmd = LCDLineAddressOne | _LCDCursorAddress; // back to DDRAM after a CGRAM write
+	}
+	if (addressCmd != 0)
+	{
+		LCDEncodeByte(addressCmd, false, nextByte);
+		nextByte += 4;
+		LCDTrackCmd(addressCmd);
+	}
+	LCDMirrorData(data, length);
+	LCDTrackData(length);
+	while (length--)
+	{
+		if (nextByte == _LCDI2CBuffer + (4 * _LCDI2CBatchSize))
+		{
+			LCDI2CWrite(_LCDI2CBuffer, nextByte - _LCDI2CBuffer);
+			if (recoverCount != _LCDRecoverCount) {return;}
+			nextByte = _LCDI2CBuffer;
+		}
+		LCDEncodeByte(*data++, true, nextByte);
+		nextByte += 4;
+	}
+	if (nextByte != _LCDI2CBuffer)
+	{
+		LCDI2CWrite(_LCDI2CBuffer, nextByte - _LCDI2CBuffer);
+	}
+}
+
+/*!
+	@brief  Encode a byte into the four PCF8574 port bytes that clock it into the LCD
+	@param value The data or command byte
+	@param isData true = data (rs=1) , false = command (rs=0)
+	@param buffer Pointer to 4 bytes to hold the encoded output
+	@note Looks up _LCDEncodeTable for the current backlight state.
+*/
+void __not_in_flash_func(HD44780LCD::LCDEncodeByte)(uint8_t value, bool isData, uint8_t *buffer) {
+	memcpy(buffer, &_LCDEncodeTable.word[(_LCDBackLight >> 3) & 0x01][isData][value], 4);
+}
+
+/*!
+	@brief  Encode a run of bytes into PCF8574 port bytes
+	@param data Pointer to the data or command bytes
+	@param length Number of bytes
+	@param isData true = data (rs=1) , false = command (rs=0)
+	@param buffer Output, must hold 4 * length bytes
+	@return number of bytes written to buffer
+	@note Encoding only, nothing is sent. Uses the current backlight state.
+*/
+size_t __not_in_flash_func(HD44780LCD::LCDEncode)(const uint8_t *data, size_t length, bool isData, uint8_t *buffer) {
+	const uint32_t *table = _LCDEncodeTable.word[(_LCDBackLight >> 3) & 0x01][isData];
+	for (size_t i = 0; i < length; i++)
+	{
+		memcpy(buffer + (4 * i), &table[data[i]], 4);
+	}
+	return 4 * length;
+}
+
+/*!
+	@brief  Build the encode table at compile time
+	@details I2C MASK Byte = DATA-led-en-rw-rs (en=enable rs = reg select)(rw always write)
+		Upper nibble first, each nibble is latched by enable going high then low.
+		The 4 port bytes are packed first byte lowest, so on the little endian RP2040
+		they sit in bus order in memory.
+	@return Table for both backlight states and both register selects
+*/
+constexpr HD44780LCD::LCDEncodeTable_t HD44780LCD::LCDEncodeTableMake(void) {
 	const uint8_t LCDDataByteOn= 0x0D; //enable=1 and rs =1 1101  DATA-led-en-rw-rs
-	const  uint8_t LCDDataByteOff = 0x09; // enable=0 and rs =1 1001 DATA-led-en-rw-rs
-	
-	unsigned char dataNibbleLower, dataNibbleUpper;
-	uint8_t dataBufferI2C[4];
-	int I2CReturnCode = 0;
-	
-	dataNibbleLower = (data << 4)&0xf0; //select lower nibble by moving it to the upper nibble position
-	dataNibbleUpper = data & 0xf0; //select upper nibble
-	dataBufferI2C[0] = dataNibbleUpper | (LCDDataByteOn & _LCDBackLight); //enable=1 and rs =1 1101  YYYY-X-en-X-rs
-	dataBufferI2C[1] = dataNibbleUpper | (LCDDataByteOff & _LCDBackLight); //enable=0 and rs =1 1001 YYYY-X-en-X-rs
-	dataBufferI2C[2] = dataNibbleLower | (LCDDataByteOn & _LCDBackLight); //enable=1 and rs =1 1101  YYYY-X-en-X-rs
-	dataBufferI2C[3] = dataNibbleLower | (LCDDataByteOff &  _LCDBackLight); //enable=0 and rs =1 1001 YYYY-X-en-X-rs
+	const uint8_t LCDDataByteOff = 0x09; // enable=0 and rs =1 1001 DATA-led-en-rw-rs
+	const uint8_t LCDCmdByteOn = 0x0C;  // enable=1 and rs =0 1100 COMD-led-en-rw-rs
+	const uint8_t LCDCmdByteOff = 0x08; // enable=0 and rs =0 1000 COMD-led-en-rw-rs
+	const uint8_t backLight[2] = {LCDBackLightOffMask, LCDBackLightOnMask};
+	LCDEncodeTable_t table = {};
 
-	I2CReturnCode = i2c_write_timeout_us(i2c, _LCDSlaveAddresI2C, dataBufferI2C, 4 , false, _LCDI2Cdelay);
-	if (I2CReturnCode < 1)
+	for (uint8_t light = 0; light < 2; light++)
 	{
-		if (_LCDSerialDebugFlag == true){
-			printf("1203 data: \r\n");
-			printf("I2C error i2c_write_blocking: \r\n");
-			printf("I2CReturnCode : %d \r\n", I2CReturnCode );
-			busy_wait_ms(100);
+		for (uint8_t isData = 0; isData < 2; isData++)
+		{
+			uint8_t maskOn = (isData ? LCDDataByteOn : LCDCmdByteOn) & backLight[light];
+			uint8_t maskOff = (isData ? LCDDataByteOff : LCDCmdByteOff) & backLight[light];
+			for (uint16_t value = 0; value < 256; value++)
+			{
+				uint8_t nibbleLower = (value << 4)&0xf0; //select lower nibble by moving it to the upper nibble position
+				uint8_t nibbleUpper = value & 0xf0; //select upper nibble
+
+				table.word[light][isData][value] =
+					(uint32_t)(nibbleUpper | maskOn) | // YYYY-X-en-X-rs ,enable=1
+					(uint32_t)(nibbleUpper | maskOff) << 8 | // YYYY-X-en-X-rs ,enable=0
+					(uint32_t)(nibbleLower | maskOn) << 16 | // YYYY-X-en-X-rs ,enable=1
+					(uint32_t)(nibbleLower | maskOff) << 24; // YYYY-X-en-X-rs ,enable=0
+			}
 		}
 	}
+	return table;
 }
 
+// 4K in SRAM , read on every byte sent so kept out of the XIP cache
+const HD44780LCD::LCDEncodeTable_t HD44780LCD::_LCDEncodeTable __not_in_flash("hd44780_encode") =
+	HD44780LCD::LCDEncodeTableMake();
+
 /*!
-	@brief  Send command byte to  lcd
-	@param cmd command byte
+	@brief  Write a buffer of encoded PCF8574 port bytes to the I2C bus in one transaction
+	@param buffer Pointer to the encoded bytes
+	@param length Number of bytes
+	@return true for success , false for I2C error
+	@details After an error the controller may be half way through a byte, so LCDRecover
+		resyncs and restores it. A recovery still pending from an earlier error runs first,
+		it restores this write too as the shadow copies and tracked state are updated before sending.
 	@note if _LCDSerialDebugFlag == true  ,will output data on I2C failures.
 */
-void HD44780LCD::LCDSendCmd(unsigned char cmd) {
-	// I2C MASK Byte = COMD-led-en-rw-rs (en=enable rs = reg select)(rw always write)
-	const uint8_t LCDCmdByteOn = 0x0C;  // enable=1 and rs =0 1100 COMD-led-en-rw-rs 
-	const uint8_t LCDCmdByteOff = 0x08; // enable=0 and rs =0 1000 COMD-led-en-rw-rs 
-	
-	unsigned char cmdNibbleLower, cmdNibbleUpper;
-	uint8_t cmdBufferI2C[4];
-	int I2CReturnCode = 0;
-	
-	cmdNibbleLower = (cmd << 4)&0xf0; //select lower nibble by moving it to the upper nibble position
-	cmdNibbleUpper = cmd & 0xf0; //select upper nibble
-	cmdBufferI2C[0] = cmdNibbleUpper | (LCDCmdByteOn & _LCDBackLight); // YYYY-1100 YYYY-led-en-rw-rs ,enable=1 and rs =0
-	cmdBufferI2C[1] = cmdNibbleUpper | (LCDCmdByteOff & _LCDBackLight); // YYYY-1000 YYYY-led-en-rw-rs ,enable=0 and rs =0
-	cmdBufferI2C[2] = cmdNibbleLower | (LCDCmdByteOn & _LCDBackLight); // YYYY-1100 YYYY-led-en-rw-rs ,enable=1 and rs =0
-	cmdBufferI2C[3] = cmdNibbleLower | (LCDCmdByteOff & _LCDBackLight); // YYYY-1000 YYYY-led-en-rw-rs ,enable=0 and rs =0
-	
-	I2CReturnCode = i2c_write_timeout_us(i2c, _LCDSlaveAddresI2C, cmdBufferI2C, 4 , false, _LCDI2Cdelay);
-	if (I2CReturnCode < 1)
+bool __not_in_flash_func(HD44780LCD::LCDI2CWrite)(const uint8_t *buffer, size_t length) {
+	if (_LCDAsyncMode != LCDAsyncOff) {LCDWaitIdle();} // keep order with queued writes
+	if (_LCDRecovering == true && _LCDRecoverFailed == true) {return false;}
+	if (_LCDRecoverPending == true && _LCDRecovering == false) {return LCDRecover();}
+#if HD44780_LCD_TRACE
+	uint64_t waitStart = time_us_64();
+#endif
+	LCDWaitReady();
+#if HD44780_LCD_TRACE
+	uint64_t writeStart = time_us_64();
+#endif
+	bool success = (_LCDPIO != nullptr) ? LCDPIOWrite(buffer, length) : LCDI2CWriteAttempts(buffer, length);
+#if HD44780_LCD_TRACE
+	LCDTraceRecord(buffer, length, waitStart, writeStart, (success == true) ? 0 : LCDTraceError);
+#endif
+	if (success == false) {_LCDRecoverPending = true;}
+	if (_LCDRecovering == true) {
+		_LCDRecoverFailed = _LCDRecoverFailed || _LCDRecoverPending;
+	} else if (_LCDRecoverPending == true) {
+		LCDRecover();
+	}
+	return success;
+}
+
+/*!
+	@brief  Write a transaction on the I2C block, retry with back off on errors
+	@param buffer Pointer to the encoded bytes
+	@param length Number of bytes
+	@return true for success , false if every attempt failed
+	@details Up to _LCDRetryMax attempts, waiting _LCDRetryBackoff uS doubled each time,
+		the bus is clocked free by LCDBusUnstick before the last one.
+		A failed attempt may have delivered part of the transaction,
+		so a recovery is flagged even if a retry succeeds.
+*/
+bool __not_in_flash_func(HD44780LCD::LCDI2CWriteAttempts)(const uint8_t *buffer, size_t length) {
+	for (uint8_t attempt = 0; attempt < _LCDRetryMax; attempt++)
 	{
+		if (attempt > 0)
+		{
+			busy_wait_us_32(_LCDRetryBackoff << (attempt - 1));
+			if (attempt == _LCDRetryMax - 1) {LCDBusUnstick();}
+#if HD44780_LCD_STATS
+			uint32_t statsLock = LCDStatsLock();
+			_LCDStats.retries++;
+			LCDStatsUnlock(statsLock);
+#endif
+		}
+#if HD44780_LCD_STATS
+		uint64_t startTime = time_us_64();
+#endif
+		int I2CReturnCode = i2c_write_timeout_us(i2c, _LCDSlaveAddresI2C, buffer, length, false, _LCDI2Cdelay);
+#if HD44780_LCD_STATS
+		LCDStatsTransaction(length, startTime, I2CReturnCode);
+#endif
+		if (I2CReturnCode >= 1) {return true;}
 		if (_LCDSerialDebugFlag == true){
-			printf("1202 cmd : \r\n");
-			printf("I2C error  i2c_write_blocking : \r\n");
+			printf("1203 LCDI2CWrite : \r\n");
+			printf("I2C error i2c_write_timeout_us: \r\n");
 			printf("I2CReturnCode : %d \r\n", I2CReturnCode );
-			busy_wait_ms(100);
 		}
+		_LCDRecoverPending = true;
+		LCDClockFallback();
+	}
+	return false;
+}
+
+/*!
+	@brief  Free a bus held low by a slave that lost its place in a byte
+	@details Pins are switched to SIO, SCL is pulsed up to 9 times until SDA is released,
+		then a STOP is sent and the pins go back to the I2C block. Lines are driven
+		open drain, by direction only with the output held low.
+*/
+void HD44780LCD::LCDBusUnstick(void)
+{
+	uint32_t halfPeriod = 500 / _CLKSpeed + 1; // uS
+
+	gpio_put(_SDataPin, 0);
+	gpio_put(_SClkPin, 0);
+	gpio_set_dir(_SDataPin, GPIO_IN);
+	gpio_set_dir(_SClkPin, GPIO_IN);
+	gpio_set_function(_SDataPin, GPIO_FUNC_SIO);
+	gpio_set_function(_SClkPin, GPIO_FUNC_SIO);
+	busy_wait_us_32(halfPeriod);
+
+	for (uint8_t pulse = 0; pulse < 9 && gpio_get(_SDataPin) == false; pulse++)
+	{
+		gpio_set_dir(_SClkPin, GPIO_OUT);
+		busy_wait_us_32(halfPeriod);
+		gpio_set_dir(_SClkPin, GPIO_IN);
+		busy_wait_us_32(halfPeriod);
+	}
+	// STOP, SDA low to high while SCL high
+	gpio_set_dir(_SClkPin, GPIO_OUT);
+	busy_wait_us_32(halfPeriod);
+	gpio_set_dir(_SDataPin, GPIO_OUT);
+	busy_wait_us_32(halfPeriod);
+	gpio_set_dir(_SClkPin, GPIO_IN);
+	busy_wait_us_32(halfPeriod);
+	gpio_set_dir(_SDataPin, GPIO_IN);
+	busy_wait_us_32(halfPeriod);
+
+	gpio_set_function(_SDataPin, GPIO_FUNC_I2C);
+	gpio_set_function(_SClkPin, GPIO_FUNC_I2C);
+}
+
+/*!
+	@brief Resync the controller and restore it from the tracked state
+	@return true for success , false if a write failed, it is tried again before the next write
+	@details Called by LCDI2CWrite after a write error. The nibbles 0x3 0x3 0x3 0x2 bring
+		the controller back to the start of a byte in 4 bit mode from any state.
+		Then the custom characters written, both DDRAM lines from the shadow copy,
+		display shift, entry mode, display control and address counter are written back.
+	@note DDRAM is only restored when the shadow copy is valid, it is lost by writing
+		with an unknown address counter. Can also be called after the LCD lost power.
+*/
+bool HD44780LCD::LCDRecover(void)
+{
+	const uint8_t LCDNibbleOn = 0x0C;  // enable=1 and rs =0 1100 COMD-led-en-rw-rs
+	const uint8_t LCDNibbleOff = 0x08; // enable=0 and rs =0 1000 COMD-led-en-rw-rs
+	const uint8_t resyncNibbles[4] = {0x30, 0x30, 0x30, 0x20}; // 8 bit mode three times, then 4 bit
+	const uint8_t LCD_CG_RAM = 0x40;
+	const uint8_t LCDShiftLeft = 0x18;
+	const uint8_t LCDShiftRight = 0x1C;
+
+	if (_LCDRecovering == true) {return false;}
+#if HD44780_LCD_STATS
+	uint64_t startTime = time_us_64();
+#endif
+	// writes below change the tracked state, put it back at the end
+	bool busyFlagMode = _LCDBusyFlagMode;
+	bool cursorKnown = _LCDCursorKnown;
+	bool cursorRestore = _LCDCursorRestore;
+	uint8_t cursorAddress = _LCDCursorAddress;
+	bool CGRAMMode = _LCDCGRAMMode;
+	uint8_t CGRAMAddress = _LCDCGRAMAddress;
+	LCDEntryMode_e entryMode = _LCDEntryMode;
+	uint8_t displayControl = _LCDDisplayControl;
+	int8_t displayShift = _LCDDisplayShift;
+
+	_LCDRecovering = true;
+	_LCDRecoverFailed = false;
+	_LCDDeferCount = 0; // queued commands are already in the tracked state
+	_LCDRecoverPending = false; // set again by any write error below
+	_LCDBusyFlagMode = false; // busy flag can not be read until controller is back in step
+	for (uint8_t i = 0; i < 4; i++)
+	{
+		uint8_t nibble[2] = {(uint8_t)(resyncNibbles[i] | (LCDNibbleOn & _LCDBackLight)),
+			(uint8_t)(resyncNibbles[i] | (LCDNibbleOff & _LCDBackLight))};
+		LCDI2CWrite(nibble, 2);
+		LCDBusyFor(i == 0 ? 4100 : 150);
+	}
+	LCDSendCmd(LCDModeFourBit);
+	LCDSendCmd(LCDDisplayOff); // hide the redraw
+	LCDSendCmd(LCDEntryModeThree);
+	LCDSendCmd(LCDHomePosition); // also undoes display shift
+	LCDBusyFor(2000);
+
+	for (uint8_t location = 0; location < 8 && _LCDRecoverFailed == false; location++)
+	{
+		if (_LCDCGRAMUsed & (1 << location)) {
+			LCDSendDataBuffer(&_LCDCGRAMShadow[location * 8], 8, LCD_CG_RAM | (location << 3));
+		}
+	}
+	if (_LCDShadowValid == true)
+	{
+		LCDSendDataBuffer(&_LCDShadowBuffer[0], _LCDDDRAMLineSize, LCDLineAddressOne);
+		LCDSendDataBuffer(&_LCDShadowBuffer[_LCDDDRAMLineSize], _LCDDDRAMLineSize, LCDLineAddressTwo);
+	}
+	while (_LCDDisplayShift != displayShift && _LCDRecoverFailed == false) {
+		LCDSendCmd(_LCDDisplayShift < displayShift ? LCDShiftRight : LCDShiftLeft);
+	}
+	LCDSendCmd(entryMode);
+	LCDSendCmd(displayControl);
+	if (CGRAMMode == true) {
+		LCDSendCmd(LCD_CG_RAM | CGRAMAddress);
+	} else if (cursorKnown == true) {
+		LCDSendCmd(LCDLineAddressOne | cursorAddress);
+	}
+
+	_LCDCursorKnown = cursorKnown;
+	_LCDCursorRestore = cursorRestore;
+	_LCDCursorAddress = cursorAddress;
+	_LCDCGRAMMode = CGRAMMode;
+	_LCDCGRAMAddress = CGRAMAddress;
+	_LCDEntryMode = entryMode;
+	_LCDDisplayControl = displayControl;
+	_LCDDisplayShift = displayShift;
+	_LCDBusyFlagMode = busyFlagMode;
+	_LCDRecovering = false;
+	_LCDRecoverPending = _LCDRecoverFailed;
+	if (_LCDRecoverFailed == true)
+	{
+		if (_LCDSerialDebugFlag == true) {
+			printf("1206 LCDRecover: LCD not restored, retry on next write.\r\n");
+		}
+		return false;
+	}
+	_LCDRecoverCount++;
+#if HD44780_LCD_STATS
+	uint32_t statsLock = LCDStatsLock();
+	_LCDStats.recoveries++;
+	_LCDStats.recoveryTime = time_us_64() - startTime;
+	LCDStatsUnlock(statsLock);
+#endif
+	return true;
+}
+
+/*!
+	@brief Check for a recovery that has not yet succeeded
+	@return true if the LCD state is unknown after an I2C error
+*/
+bool HD44780LCD::LCDRecoverPendingGet(void){return _LCDRecoverPending;}
+
+/*!
+	@brief  Set the maximum number of bytes sent in one I2C transaction for strings and buffers
+	@param batchSize Data bytes per transaction 1 to _LCDI2CBatchMax, each data byte is 4 bytes on the bus.
+	@note Larger batches amortise the I2C address and start/stop overhead,
+		smaller batches keep the bus free for other devices. Default is _LCDI2CBatchMax.
+*/
+void HD44780LCD::LCDI2CBatchSizeSet(uint8_t batchSize)
+{
+	if (batchSize < 1) {batchSize = 1;}
+	if (batchSize > _LCDI2CBatchMax) {batchSize = _LCDI2CBatchMax;}
+	_LCDI2CBatchSize = batchSize;
+}
+
+uint8_t HD44780LCD::LCDI2CBatchSizeGet(void){return _LCDI2CBatchSize;}
+
+/*!
+	@brief Get a copy of the bus counters
+	@param snapshot Filled with the counters, zeros if they are compiled out
+	@return true if counters are collected , false if HD44780_LCD_STATS is 0
+	@note Safe from either core, copied under the stats spin lock so the counters are
+		consistent with each other.
+*/
+bool HD44780LCD::LCDStatsGet(LCDStats_t &snapshot)
+{
+#if HD44780_LCD_STATS
+	uint32_t statsLock = LCDStatsLock();
+	snapshot = _LCDStats;
+	LCDStatsUnlock(statsLock);
+	return true;
+#else
+	snapshot = LCDStats_t{};
+	return false;
+#endif
+}
+
+/*!
+	@brief Set the bus counters to zero
+*/
+void HD44780LCD::LCDStatsReset(void)
+{
+#if HD44780_LCD_STATS
+	uint32_t statsLock = LCDStatsLock();
+	_LCDStats = LCDStats_t{};
+	LCDStatsUnlock(statsLock);
+#endif
+}
+
+#if HD44780_LCD_STATS
+/*!
+	@brief Take the stats spin lock before touching the bus counters
+	@return Interrupt state for LCDStatsUnlock
+	@details A striped hardware spin lock with interrupts off, so the other core and
+		the async interrupt on this core never see a counter update half done.
+*/
+uint32_t __not_in_flash_func(HD44780LCD::LCDStatsLock)(void)
+{
+	return spin_lock_blocking(_LCDStatsSpinLock);
+}
+
+/*!
+	@brief Release the stats spin lock
+	@param interrupts Return of LCDStatsLock
+*/
+void __not_in_flash_func(HD44780LCD::LCDStatsUnlock)(uint32_t interrupts)
+{
+	spin_unlock(_LCDStatsSpinLock, interrupts);
+}
+#endif
+
+#if HD44780_LCD_STATS
+/*!
+	@brief Count one blocking I2C write in the bus counters
+	@param length Bytes in the transaction
+	@param startTime time_us_64 before the write
+	@param returnCode Return of i2c_write_timeout_us, PICO_ERROR_GENERIC is a NACK
+*/
+void __not_in_flash_func(HD44780LCD::LCDStatsTransaction)(size_t length, uint64_t startTime, int returnCode)
+{
+	uint32_t elapsed = (uint32_t)(time_us_64() - startTime);
+	uint8_t bucket = (elapsed > 1) ? (31 - __builtin_clz(elapsed)) : 0;
+	if (bucket >= LCDStatsBuckets) {bucket = LCDStatsBuckets - 1;}
+
+	uint32_t statsLock = LCDStatsLock();
+	_LCDStats.transactions++;
+	_LCDStats.bytes += length;
+	_LCDStats.busyTime += elapsed;
+	_LCDStats.latency[bucket]++;
+	if (returnCode == PICO_ERROR_GENERIC) {_LCDStats.nacks++;}
+	if (returnCode == PICO_ERROR_TIMEOUT) {_LCDStats.timeouts++;}
+	LCDStatsUnlock(statsLock);
+}
+#endif
+
+// Section : Trace
+
+/*!
+	@brief Turn recording of I2C transactions on and off
+	@param OnOff true = record each transaction in the trace ring
+	@return true if tracing is compiled in , false if HD44780_LCD_TRACE is 0
+	@details Each record holds the start time, the time spent waiting for the controller
+		before the write, the write time, flags and the PCF8574 port bytes. When the ring
+		is full the oldest records are dropped. See LCDTraceDump and extra/tools/hd44780_trace.py.
+*/
+bool HD44780LCD::LCDTraceModeSet(bool OnOff)
+{
+#if HD44780_LCD_TRACE
+	_LCDTraceMode = OnOff;
+	return true;
+#else
+	(void)OnOff;
+	return false;
+#endif
+}
+
+bool HD44780LCD::LCDTraceModeGet(void)
+{
+#if HD44780_LCD_TRACE
+	return _LCDTraceMode;
+#else
+	return false;
+#endif
+}
+
+/*!
+	@brief Write the trace ring to stdio as binary and empty it
+	@return Number of bytes written , 0 if tracing is compiled out
+	@details Bytes go out raw with putchar_raw, capture them from the USB or UART port
+		to a file, text before and after is skipped by the tool. Format, little endian :
+		-# Header : "HDT1" , rows u8 , columns u8 , I2C clock KHz u16 , dropped records u32 , record bytes u32
+		-# Records : time uS u32 , wait uS u16 , write uS u16 , length u16 , flags u8 , port bytes
+		Flags : 0x01 transaction failed , 0x02 queued for async DMA , 0x04 port bytes cut short,
+		0x08 read , the bytes are what the PCF8574 returned.
+*/
+size_t HD44780LCD::LCDTraceDump(void)
+{
+#if HD44780_LCD_TRACE
+	uint32_t used = _LCDTraceUsed;
+	uint8_t header[16] = {'H', 'D', 'T', '1', _NumRowsLCD, _NumColsLCD,
+		(uint8_t)_CLKSpeed, (uint8_t)(_CLKSpeed >> 8),
+		(uint8_t)_LCDTraceDropped, (uint8_t)(_LCDTraceDropped >> 8),
+		(uint8_t)(_LCDTraceDropped >> 16), (uint8_t)(_LCDTraceDropped >> 24),
+		(uint8_t)used, (uint8_t)(used >> 8), (uint8_t)(used >> 16), (uint8_t)(used >> 24)};
+
+	for (uint8_t i = 0; i < sizeof(header); i++) {putchar_raw(header[i]);}
+	for (size_t i = 0; i < used; i++) {
+		putchar_raw(_LCDTraceRing[(_LCDTraceTail + i) % HD44780_LCD_TRACE_SIZE]);
+	}
+	stdio_flush();
+	LCDTraceClear();
+	return sizeof(header) + used;
+#else
+	return 0;
+#endif
+}
+
+/*!
+	@brief Empty the trace ring and zero the dropped record count
+*/
+void HD44780LCD::LCDTraceClear(void)
+{
+#if HD44780_LCD_TRACE
+	_LCDTraceHead = 0;
+	_LCDTraceTail = 0;
+	_LCDTraceUsed = 0;
+	_LCDTraceDropped = 0;
+#endif
+}
+
+#if HD44780_LCD_TRACE
+/*!
+	@brief Add a transaction to the trace ring, dropping the oldest records to make room
+	@param buffer PCF8574 port bytes
+	@param length Number of bytes
+	@param waitStart time_us_64 before waiting for the controller
+	@param writeStart time_us_64 before the write
+	@param flags LCDTraceError , LCDTraceAsync , LCDTraceRead
+*/
+void __not_in_flash_func(HD44780LCD::LCDTraceRecord)(const uint8_t *buffer, size_t length,
+	uint64_t waitStart, uint64_t writeStart, uint8_t flags)
+{
+	if (_LCDTraceMode == false) {return;}
+	uint64_t writeEnd = (flags & LCDTraceAsync) ? writeStart : time_us_64();
+	uint32_t wait = (uint32_t)(writeStart - waitStart);
+	uint32_t duration = (uint32_t)(writeEnd - writeStart);
+	if (wait > UINT16_MAX) {wait = UINT16_MAX;}
+	if (duration > UINT16_MAX) {duration = UINT16_MAX;}
+	if (length > HD44780_LCD_TRACE_SIZE - _LCDTraceHeaderSize)
+	{
+		length = HD44780_LCD_TRACE_SIZE - _LCDTraceHeaderSize;
+		flags |= LCDTraceTruncated;
+	}
+
+	while (HD44780_LCD_TRACE_SIZE - _LCDTraceUsed < _LCDTraceHeaderSize + length)
+	{
+		size_t lengthIndex = _LCDTraceTail + 8; // length field of the oldest record
+		size_t oldLength = _LCDTraceRing[lengthIndex % HD44780_LCD_TRACE_SIZE] |
+			(_LCDTraceRing[(lengthIndex + 1) % HD44780_LCD_TRACE_SIZE] << 8);
+		_LCDTraceTail = (_LCDTraceTail + _LCDTraceHeaderSize + oldLength) % HD44780_LCD_TRACE_SIZE;
+		_LCDTraceUsed -= _LCDTraceHeaderSize + oldLength;
+		_LCDTraceDropped++;
+	}
+
+	uint32_t time = (uint32_t)writeStart;
+	uint8_t header[_LCDTraceHeaderSize] = {(uint8_t)time, (uint8_t)(time >> 8),
+		(uint8_t)(time >> 16), (uint8_t)(time >> 24),
+		(uint8_t)wait, (uint8_t)(wait >> 8), (uint8_t)duration, (uint8_t)(duration >> 8),
+		(uint8_t)length, (uint8_t)(length >> 8), flags};
+	LCDTracePut(header, _LCDTraceHeaderSize);
+	LCDTracePut(buffer, length);
+}
+
+/*!
+	@brief Copy bytes into the trace ring at the head, room is made by the caller
+	@param bytes Bytes to copy
+	@param length Number of bytes
+*/
+void __not_in_flash_func(HD44780LCD::LCDTracePut)(const uint8_t *bytes, size_t length)
+{
+	for (size_t i = 0; i < length; i++)
+	{
+		_LCDTraceRing[_LCDTraceHead] = bytes[i];
+		_LCDTraceHead = (_LCDTraceHead + 1) % HD44780_LCD_TRACE_SIZE;
+	}
+	_LCDTraceUsed += length;
+}
+#endif
+
+/*!
+	@brief Find the fastest I2C clock the PCF8574 handles reliably and use it
+	@param maxKHz Highest rate to try in KHz, 1000 is the limit of the I2C block
+	@return The chosen rate in KHz
+	@details Steps up through _LCDClockSteps from the current rate. At each rate the
+		port is written and read back _LCDClockProbes times with enable low, so the LCD
+		ignores it. The first rate with an error or maxKHz ends the search and the rate
+		one step below the highest good one is used as a safety margin, never below the
+		rate at the start. After tuning, write errors that spike step the rate back down
+		at runtime, never below the rate at the start of tuning.
+	@note Call after LCDInit. PIO transport is write only and keeps its rate.
+*/
+uint16_t HD44780LCD::LCDAutoTuneClock(uint16_t maxKHz)
+{
+	const uint8_t numSteps = sizeof(_LCDClockSteps) / sizeof(_LCDClockSteps[0]);
+	uint16_t startKHz = _CLKSpeed;
+	int8_t lastGood = -1;
+
+	if (_LCDPIO != nullptr) {return _CLKSpeed;}
+	if (_LCDAsyncMode != LCDAsyncOff) {LCDWaitIdle();}
+	LCDWaitReady();
+
+	for (uint8_t step = 0; step < numSteps && _LCDClockSteps[step] <= maxKHz; step++)
+	{
+		if (_LCDClockSteps[step] < startKHz) {continue;}
+		i2c_set_baudrate(i2c, _LCDClockSteps[step] * 1000);
+		if (LCDClockProbe() == false) {break;}
+		lastGood = step;
+	}
+	// the highest good rate is the untested edge, also when every rate passed
+	if (lastGood > 0 && _LCDClockSteps[lastGood - 1] >= startKHz) {lastGood--;}
+	_CLKSpeed = (lastGood >= 0) ? _LCDClockSteps[lastGood] : startKHz;
+	i2c_set_baudrate(i2c, _CLKSpeed * 1000);
+	_LCDClockMinKHz = startKHz;
+	_LCDClockErrors = 0;
+	if (_LCDSerialDebugFlag == true) {
+		printf("LCDAutoTuneClock : %u KHz\r\n", _CLKSpeed);
+	}
+	return _CLKSpeed;
+}
+
+/*!
+	@brief Get the I2C clock rate in use
+	@return Rate in KHz, set by constructor , LCDAutoTuneClock or runtime fall back
+*/
+uint16_t HD44780LCD::LCDClockSpeedGet(void){return _CLKSpeed;}
+
+/*!
+	@brief Write test patterns to the PCF8574 port and read them back at the current rate
+	@return true if every write and read back matched
+	@details Enable and R/W stay low so the LCD does not latch anything,
+		the data lines read back what was written. Backlight is kept as it is.
+*/
+bool HD44780LCD::LCDClockProbe(void)
+{
+	const uint8_t patterns[4] = {0xF1, 0x00, 0xA0, 0x51}; // DATA-led-en-rw-rs , en=0 rw=0
+	const uint8_t ledBit = _LCDBackLight & 0x08;
+
+	for (uint8_t probe = 0; probe < _LCDClockProbes; probe++)
+	{
+		uint8_t written = patterns[probe % 4] | ledBit;
+		uint8_t readBack = ~written;
+		if (LCDI2CTransfer(&written, 1, false) < 1) {return false;}
+		if (LCDI2CTransfer(&readBack, 1, true) < 1) {return false;}
+		if (readBack != written) {return false;}
+	}
+	return true;
+}
+
+/*!
+	@brief Count a write error and step the clock down if errors spike
+	@details Active after LCDAutoTuneClock. _LCDClockErrorLimit errors within
+		_LCDClockErrorWindow uS drop the rate one step, down to the rate tuning started from.
+*/
+void HD44780LCD::LCDClockFallback(void)
+{
+	if (_LCDClockMinKHz == 0 || _CLKSpeed <= _LCDClockMinKHz) {return;}
+	if (absolute_time_diff_us(_LCDClockWindowStart, get_absolute_time()) > _LCDClockErrorWindow)
+	{
+		_LCDClockWindowStart = get_absolute_time();
+		_LCDClockErrors = 0;
 	}
+	if (++_LCDClockErrors < _LCDClockErrorLimit) {return;}
 
+	uint16_t lowerKHz = _LCDClockMinKHz;
+	for (uint16_t stepKHz : _LCDClockSteps)
+	{
+		if (stepKHz < _CLKSpeed && stepKHz > lowerKHz) {lowerKHz = stepKHz;}
+	}
+	_CLKSpeed = lowerKHz;
+	i2c_set_baudrate(i2c, _CLKSpeed * 1000);
+	_LCDClockErrors = 0;
+	if (_LCDSerialDebugFlag == true) {
+		printf("LCDClockFallback : %u KHz\r\n", _CLKSpeed);
+	}
 }
 
 /*!
@@ -96,29 +752,131 @@ void HD44780LCD::LCDSendCmd(unsigned char cmd) {
 	@param lineNo LCDLineNumber_e enum lineNo  1-4
 */
 void HD44780LCD::LCDClearLine(LCDLineNumber_e lineNo) {
+	uint8_t spaces[_LCDDDRAMLineSize];
+	memset(spaces, ' ', _NumColsLCD);
 
-	switch (lineNo) {
-		case LCDLineNumberOne:LCDSendCmd(LCDLineAddressOne); break;
-		case LCDLineNumberTwo:LCDSendCmd(LCDLineAddressTwo); break;
-		case LCDLineNumberThree:
-			switch (_NumColsLCD)
-			{
-				case 16: LCDSendCmd(LCDLineAddress3Col16); break;
-				case 20: LCDSendCmd(LCDLineAddress3Col20); break;
-			}
-		break;
-		case LCDLineNumberFour:
-			switch (_NumColsLCD)
-			{
-				case 16: LCDSendCmd(LCDLineAddress4Col16); break;
-				case 20: LCDSendCmd(LCDLineAddress4Col20); break;
+	// Most lines are one run of DDRAM, 16x01 is two runs of 8
+	for (uint8_t col = 0; col < _NumColsLCD; )
+	{
+		uint8_t length = ((col < _LCDSplitColumn) ? _LCDSplitColumn : _NumColsLCD) - col;
+		uint8_t addressCmd = LCDCellAddressCmd(lineNo, col);
+		if (addressCmd == 0) {return;}
+
+		if (_LCDBufferMode == true)
+		{
+			_LCDBufferAddress = addressCmd & ~LCDLineAddressOne;
+			for (uint8_t i = 0; i < length; i++) {
+				LCDPutChar(' ');
 			}
-		break;
+		} else {
+			LCDSendDataBuffer(spaces, length, addressCmd);
+		}
+		col += length;
+	}
+}
+
+/*!
+	@brief  Find where a run of changed cells ends
+	@param changed Cell differs from what is on screen
+	@param follows DDRAM address of the cell is one on from the cell before
+	@param start First cell of the run , a changed cell
+	@param count Cells in the region
+	@return Cell after the run
+	@details A single unchanged cell between two changed ones joins them, sending it again
+		costs the same as a new address command. Runs break where addresses are not in sequence.
+		Shared by LCDWriteLine and HD44780LCDMarquee.
+*/
+uint8_t HD44780LCD::LCDChangedRunEnd(const bool *changed, const bool *follows, uint8_t start, uint8_t count) {
+	uint8_t runEnd = start + 1;
+	while (runEnd < count && follows[runEnd] == true)
+	{
+		if (changed[runEnd] == true) {
+			runEnd++;
+		} else if (runEnd + 1 < count && changed[runEnd + 1] == true && follows[runEnd + 1] == true) {
+			runEnd += 2;
+		} else {
+			break;
+		}
+	}
+	return runEnd;
+}
+
+/*!
+	@brief  Replace the content of a row, sending only the characters that changed
+	@param lineNo  row 1-4
+	@param text  New row content, padded with spaces or cut at the end to the row width
+	@param align  Position of text shorter than the row
+	@return Number of bytes written on the I2C bus, 0 when the row already shows the text
+	@details Compares with the shadow copy of DDRAM, each run of changed characters is
+		one set address command and its characters, see LCDChangedRunEnd.
+		If the shadow copy is not valid the whole row is sent. Commands queued in deferred
+		mode go out ahead of the first run and are counted, as is the address back from CGRAM.
+	@note In buffered mode the frame buffer is updated and LCDFlush sends it, returns 0.
+*/
+uint16_t HD44780LCD::LCDWriteLine(LCDLineNumber_e lineNo, std::string_view text, LCDAlign_e align) {
+	const uint8_t I2CBytesPerByte = 4; // two nibbles , each with enable high and low
+	uint8_t cells[_LCDDDRAMLineSize];
+	uint8_t addresses[_LCDDDRAMLineSize];
+	bool changed[_LCDDDRAMLineSize];
+	bool follows[_LCDDDRAMLineSize]; // DDRAM address is one on from the column before
+	uint16_t bytesSent = 0;
+
+	if (lineNo < 1 || lineNo > _NumRowsLCD || _NumColsLCD > _LCDDDRAMLineSize) {return 0;}
+	uint8_t length = (text.length() < _NumColsLCD) ? text.length() : _NumColsLCD;
+	uint8_t space = _NumColsLCD - length;
+	uint8_t start = (align == LCDAlignRight) ? space : ((align == LCDAlignCenter) ? space / 2 : 0);
+	memset(cells, ' ', _NumColsLCD);
+	memcpy(&cells[start], text.data(), length);
+
+	const uint8_t *current = _LCDBufferMode ? _LCDFrameBuffer : _LCDShadowBuffer;
+	bool currentKnown = _LCDBufferMode || _LCDShadowValid;
+	for (uint8_t col = 0; col < _NumColsLCD; col++)
+	{
+		addresses[col] = LCDCellAddressCmd(lineNo, col) & ~LCDLineAddressOne;
+		changed[col] = !currentKnown || current[LCDAddressToIndex(addresses[col])] != cells[col];
+		follows[col] = col > 0 && addresses[col] == addresses[col - 1] + 1;
+	}
+
+	if (_LCDBufferMode == true)
+	{
+		for (uint8_t col = 0; col < _NumColsLCD; col++)
+		{
+			if (changed[col] == false) {continue;}
+			_LCDFrameBuffer[LCDAddressToIndex(addresses[col])] = cells[col];
+			_LCDBufferDirty = true;
+		}
+		return 0;
 	}
 
-	for (uint8_t i = 0; i < _NumColsLCD; i++) {
-		LCDSendData(' ');
+	bool increment = _LCDEntryMode & LCDEntryIncrementBit;
+	uint8_t col = 0;
+	while (col < _NumColsLCD)
+	{
+		if (changed[col] == false) {
+			col++;
+			continue;
+		}
+		// runs do not cross a DDRAM address jump, column 8 of a 16x01
+		uint8_t runEnd = LCDChangedRunEnd(changed, follows, col, _NumColsLCD);
+		uint8_t runLength = runEnd - col;
+		// Address counter decrements in entry modes one and two, so write run backwards
+		if (increment == true) {
+			bool atAddress = (_LCDCursorKnown == true && _LCDCursorAddress == addresses[col]);
+			if (_LCDDeferCount > 0) {bytesSent += LCDDeferEmit(!atAddress, false);}
+			LCDSendDataBuffer(&cells[col], runLength, atAddress ? 0 : (LCDLineAddressOne | addresses[col]));
+			bytesSent += I2CBytesPerByte * ((atAddress ? 0 : 1) + runLength);
+		} else {
+			uint8_t reversed[_LCDDDRAMLineSize];
+			for (uint8_t i = 0; i < runLength; i++) {
+				reversed[i] = cells[runEnd - 1 - i];
+			}
+			if (_LCDDeferCount > 0) {bytesSent += LCDDeferEmit(true, false);}
+			LCDSendDataBuffer(reversed, runLength, LCDLineAddressOne | addresses[runEnd - 1]);
+			bytesSent += I2CBytesPerByte * (1 + runLength);
+		}
+		col = runEnd;
 	}
+	return bytesSent;
 }
 
 /*!
@@ -149,7 +907,8 @@ void HD44780LCD::LCDResetScreen(LCDCursorType_e CursorType) {
 	LCDSendCmd(CursorType);
 	LCDSendCmd(LCDClearTheScreen);
 	LCDSendCmd(LCDEntryModeThree);
-	busy_wait_ms(5);
+	LCDBufferClear();
+	LCDBusyFor(5000);
 }
 
 
@@ -159,7 +918,7 @@ void HD44780LCD::LCDResetScreen(LCDCursorType_e CursorType) {
 */
 void HD44780LCD::LCDDisplayON(bool OnOff) {
 	OnOff ? LCDSendCmd(LCDDisplayOn) : LCDSendCmd(LCDDisplayOff);
-	busy_wait_ms(5);
+	LCDBusyFor(5000);
 }
 
 
@@ -174,25 +933,34 @@ bool HD44780LCD::LCDInit(LCDCursorType_e cursorType, uint8_t NumRow, uint8_t Num
 
 	_NumRowsLCD = NumRow;
 	_NumColsLCD = NumCol;
+	for (uint8_t row = 0; row < 4; row++) {
+		_LCDRowAddress[row] = LCDCellAddress(NumRow, NumCol, row + 1, 0);
+	}
+	_LCDSplitColumn = (NumRow == 1 && NumCol == 16) ? 8 : NumCol;
 
 	if (LCD_I2C_ON() == false)
 	{
 		return false;
 	}
 	
-	busy_wait_ms(15);
+	// busy flag can not be read until controller is in 4 bit mode
+	bool busyFlagMode = _LCDBusyFlagMode;
+	_LCDBusyFlagMode = false;
+	LCDBusyFor(15000);
 	LCDSendCmd(LCDHomePosition);
-	busy_wait_ms(5);
+	LCDBusyFor(5000);
 	LCDSendCmd(LCDHomePosition);
-	busy_wait_ms(5);
+	LCDBusyFor(5000);
 	LCDSendCmd(LCDHomePosition);
-	busy_wait_ms(5);
+	LCDBusyFor(5000);
 	LCDSendCmd(LCDModeFourBit);
+	_LCDBusyFlagMode = busyFlagMode;
 	LCDSendCmd(LCDDisplayOn);
 	LCDSendCmd(cursorType);
 	LCDSendCmd(LCDEntryModeThree);
 	LCDSendCmd(LCDClearTheScreen);
-	busy_wait_ms(5);
+	LCDBufferClear();
+	LCDBusyFor(5000);
 	return true;
 }
 
@@ -200,17 +968,60 @@ bool HD44780LCD::LCDInit(LCDCursorType_e cursorType, uint8_t NumRow, uint8_t Num
 	@brief  Send a string to LCD
 	@param str  Pointer to the char array
 */
-void HD44780LCD::LCDSendString(char *str) {
-	while (*str) LCDSendData(*str++);
+void HD44780LCD::LCDSendString(const char *str) {
+	write(str);
 }
 
-
 /*!
-	@brief  Sends a character to screen , simply wraps SendData command.
-	@param data Character to display
+	@brief  Send a string to LCD, length delimited, no null terminator needed
+	@param str  View of the characters, not copied
+*/
+void HD44780LCD::LCDSendString(std::string_view str) {
+	write(str.data(), str.length());
+}
+
+/*!
+	@brief  Formatted print to LCD through a buffer on the stack
+	@param format printf style format string
+	@return Number of characters written, output is cut at _LCDPrintfMax
+	@note No heap use with the Pico SDK printf, which replaces vsnprintf of the C library.
+*/
+size_t HD44780LCD::LCDPrintf(const char *format, ...) {
+	char text[_LCDPrintfMax + 1];
+	va_list args;
+
+	va_start(args, format);
+	int length = vsnprintf(text, sizeof(text), format, args);
+	va_end(args);
+	if (length <= 0) {return 0;}
+	return write(text, ((size_t)length < sizeof(text)) ? (size_t)length : sizeof(text) - 1);
+}
+
+/*!
+	@brief  Formatted print to LCD through a buffer given by the caller
+	@param buffer Buffer for the formatted text
+	@param size Size of buffer in bytes including the null terminator
+	@param format printf style format string
+	@return Number of characters written, output is cut at size - 1
+*/
+size_t HD44780LCD::LCDPrintfBuffer(char *buffer, size_t size, const char *format, ...) {
+	va_list args;
+
+	if (buffer == nullptr || size == 0) {return 0;}
+	va_start(args, format);
+	int length = vsnprintf(buffer, size, format, args);
+	va_end(args);
+	if (length <= 0) {return 0;}
+	return write(buffer, ((size_t)length < size) ? (size_t)length : size - 1);
+}
+
+
+/*!
+	@brief  Sends a character to screen , simply wraps SendData command.
+	@param data Character to display
 */
 void HD44780LCD::LCDSendChar(char data) {
-	LCDSendData(data);
+	LCDPutChar(data);
 }
 
 /*!
@@ -222,6 +1033,28 @@ void HD44780LCD::LCDMoveCursor(LCDDirectionType_e direction, uint8_t moveSize) {
 	uint8_t i = 0;
 	const uint8_t LCDMoveCursorLeft = 0x10;  //Command Byte Code:  Move cursor one character left 
 	const uint8_t LCDMoveCursorRight = 0x14;  // Command Byte Code : Move cursor one character right 
+
+	if (_LCDBufferMode == true)
+	{
+		for (i = 0; i < moveSize; i++) {
+			_LCDBufferAddress = LCDAddressStep(_LCDBufferAddress, direction == LCDMoveRight);
+		}
+		return;
+	}
+
+	// Position known, one set address command instead of moveSize shift commands
+	if (_LCDCursorKnown == true)
+	{
+		uint8_t address = _LCDCursorAddress;
+		for (i = 0; i < moveSize; i++) {
+			address = LCDAddressStep(address, direction == LCDMoveRight);
+		}
+		if (address != _LCDCursorAddress) {
+			LCDSendCmd(LCDLineAddressOne | address);
+		}
+		return;
+	}
+
 	switch(direction)
 	{
 	case LCDMoveRight:
@@ -270,30 +1103,49 @@ void HD44780LCD::LCDScroll(LCDDirectionType_e direction, uint8_t ScrollSize) {
 	@param col y column  0-15 or 0-19
 */
 void HD44780LCD::LCDGOTO(LCDLineNumber_e line, uint8_t col) {
-	switch (line) {
-		case LCDLineNumberOne: LCDSendCmd(LCDLineAddressOne| col); break;
-		case LCDLineNumberTwo: LCDSendCmd(LCDLineAddressTwo | col); break;
-		case LCDLineNumberThree:
-			switch (_NumColsLCD)
-			{
-				case 16: LCDSendCmd(LCDLineAddress3Col16 | col); break;
-				case 20: LCDSendCmd(LCDLineAddress3Col20 + col); break;
-			}
-		break;
-		case LCDLineNumberFour:
-			switch (_NumColsLCD)
-			{
-				case 16: LCDSendCmd(LCDLineAddress4Col16 | col); break;
-				case 20: LCDSendCmd(LCDLineAddress4Col20 + col); break;
-			}
-		break;
+	uint8_t addressCmd = LCDCellAddressCmd(line, col);
+	if (addressCmd == 0) {return;}
+	LCDGOTOAddress(addressCmd & ~LCDLineAddressOne);
+}
+
+/*!
+	@brief  moves cursor to a DDRAM address
+	@param  address DDRAM address 0x00-0x27 or 0x40-0x67
+	@return true if the set address command was sent , false if the cursor is already there
+	@note In buffered mode only the frame buffer write position is moved.
+*/
+bool HD44780LCD::LCDGOTOAddress(uint8_t address) {
+	if (_LCDBufferMode == true)
+	{
+		_LCDBufferAddress = address;
+		return false;
 	}
+	// already there, after the previous write for example , a pending CGRAM restore costs the same
+	if (_LCDCursorKnown == true && _LCDCursorRestore == false && _LCDCursorAddress == address) {return false;}
+	LCDSendCmd(LCDLineAddressOne | address);
+	return true;
+}
+
+/*!
+	@brief  Get the DDRAM set address command for a position on the display
+	@param  line  row 1-4
+	@param  col  column
+	@return Command byte, 0 if row is not on this LCD.
+	@note Uses the row table built by LCDInit, see LCDCellAddress.
+*/
+uint8_t HD44780LCD::LCDCellAddressCmd(LCDLineNumber_e line, uint8_t col) {
+	if (line < LCDLineNumberOne || line > _NumRowsLCD) {return 0;}
+	// only the 16x01 splits, columns past the edge of other sizes stay in the row's DDRAM
+	uint8_t address = (col >= _LCDSplitColumn && _LCDSplitColumn < _NumColsLCD) ?
+		(0x40 + col - _LCDSplitColumn) : (_LCDRowAddress[line - 1] + col);
+	return LCDLineAddressOne | address;
 }
 
 /*!
 	@brief  Saves a custom character to a location in character generator RAM 64 bytes.
 	@param location CG_RAM location 0-7, we only have 8 locations 64 bytes
 	@param charmap An array of 8 bytes representing a custom character data
+	@note If the cursor position was known, the next character written goes back to it.
 */
 void HD44780LCD::LCDCreateCustomChar(uint8_t location, uint8_t * charmap)
 {
@@ -301,10 +1153,7 @@ void HD44780LCD::LCDCreateCustomChar(uint8_t location, uint8_t * charmap)
 	const uint8_t LCD_CG_RAM = 0x40;  //  character-generator RAM (CG RAM address) 
 	 if (location >= 8) {return;}
 	 
-	LCDSendCmd(LCD_CG_RAM | (location<<3));
-	for (uint8_t i=0; i<8; i++) {
-		LCDSendData(charmap[i]);
-	}
+	LCDSendDataBuffer(charmap, 8, LCD_CG_RAM | (location<<3));
 }
 
 /*!
@@ -344,12 +1193,16 @@ bool HD44780LCD::LCD_I2C_ON()
 	int TransmissionCode = 0;
 	uint8_t rxdata;
 
-	// init I2c pins and interface
-	gpio_set_function(_SDataPin, GPIO_FUNC_I2C);
-	gpio_set_function(_SClkPin, GPIO_FUNC_I2C);
-	gpio_pull_up(_SDataPin);
-	gpio_pull_up(_SClkPin);
-	if (i2c_init(i2c, _CLKSpeed * 1000) != _CLKSpeed * 1000)
+	if (_LCDPIO != nullptr) {return LCDPIOBegin();}
+	// init I2c pins and interface , unless bus is set up by its owner
+	if (_LCDSharedBus == false)
+	{
+		gpio_set_function(_SDataPin, GPIO_FUNC_I2C);
+		gpio_set_function(_SClkPin, GPIO_FUNC_I2C);
+		gpio_pull_up(_SDataPin);
+		gpio_pull_up(_SClkPin);
+	}
+	if (_LCDSharedBus == false && i2c_init(i2c, _CLKSpeed * 1000) != _CLKSpeed * 1000)
 	{
 		if (_LCDSerialDebugFlag == true)
 		{
@@ -376,7 +1229,7 @@ bool HD44780LCD::LCD_I2C_ON()
 void HD44780LCD::LCDPrintCustomChar(uint8_t location)
 {
 	if (location >= 8) {return;}
-	LCDSendData(location);
+	LCDPutChar(location);
 }
 
 /*!
@@ -386,17 +1239,38 @@ void HD44780LCD::LCDPrintCustomChar(uint8_t location)
 */
 size_t HD44780LCD::write(uint8_t character)
 {
-	LCDSendChar(character) ;
+	LCDPutChar(character) ;
 	return 1;
 }
 
+/*!
+	@brief  Called by print class, writes a run of characters
+	@param buffer Pointer to the characters
+	@param size Number of characters
+	@return Number of characters written
+	@note Sent in batched I2C transactions when buffered mode is off.
+*/
+size_t HD44780LCD::write(const uint8_t *buffer, size_t size)
+{
+	if (_LCDBufferMode == true)
+	{
+		for (size_t i = 0; i < size; i++) {
+			LCDPutChar(buffer[i]);
+		}
+		return size;
+	}
+	LCDSendDataBuffer(buffer, size);
+	return size;
+}
+
 /*!
 	@brief Clear display using software command , set cursor position to zero
 	@note  See also LCDClearScreen for manual clear
  */
 void HD44780LCD::LCDClearScreenCmd(void) {
 	LCDSendCmd(LCDClearTheScreen);
-	busy_wait_ms(3); // Requires a delay
+	LCDBufferClear();
+	LCDBusyFor(3000); // Requires a delay, next bus write waits for it
 }
 
 /*!
@@ -404,7 +1278,7 @@ void HD44780LCD::LCDClearScreenCmd(void) {
  */
 void HD44780LCD::LCDHome(void) {
 	LCDSendCmd(LCDHomePosition);
-	busy_wait_ms(3); // Requires a delay
+	LCDBusyFor(3000); // Requires a delay, next bus write waits for it
 }
 
 /*!
@@ -414,7 +1288,145 @@ void HD44780LCD::LCDHome(void) {
 void HD44780LCD::LCDChangeEntryMode(LCDEntryMode_e newEntryMode)
 {
 	LCDSendCmd(newEntryMode);
-	busy_wait_ms(3); // Requires a delay
+	LCDBusyFor(3000); // Requires a delay, next bus write waits for it
+}
+
+/*!
+	@brief Check if the LCD controller has finished the last slow command
+	@return true if the next bus write will not have to wait
+	@note Clear, home, entry mode, display on/off, reset and init record a
+		busy until time instead of blocking, so the caller can do other work meanwhile.
+*/
+bool HD44780LCD::LCDIsReady(void)
+{
+	return time_reached(_LCDBusyUntil);
+}
+
+/*!
+	@brief Service the LCD without blocking
+	@return true if the controller is ready and the async queue (if used) is empty
+	@note Call from the main loop instead of waiting on slow commands.
+*/
+bool HD44780LCD::LCDPoll(void)
+{
+	bool idle = LCDAsyncPoll();
+	return idle && LCDIsReady();
+}
+
+/*!
+	@brief Wait until controller has finished the last slow command
+	@details Fixed delay mode waits for the busy until time.
+		Busy flag mode reads the busy flag until it clears, with the busy until time as a timeout,
+		so commands complete as soon as the controller is ready.
+*/
+void __not_in_flash_func(HD44780LCD::LCDWaitReady)(void)
+{
+	if (_LCDBusyFlagMode == true)
+	{
+		while (!time_reached(_LCDBusyUntil))
+		{
+			int16_t busyAddress = LCDReadBusyAddress();
+			if (busyAddress < 0) {break;} // read failed, fall back to fixed delay
+			if (!(busyAddress & LCDBusyFlagMask))
+			{
+				_LCDBusyUntil = get_absolute_time();
+				return;
+			}
+		}
+	}
+	busy_wait_until(_LCDBusyUntil);
+}
+
+/*!
+	@brief Turn busy flag mode on and off
+	@param OnOff true = read busy flag back through PCF8574 after slow commands,
+		false = always wait the fixed datasheet delay.
+	@note The R/W line of the LCD must be wired to PCF8574 P1, as on the common backpacks.
+		Async DMA transfers still use the fixed delay.
+*/
+void HD44780LCD::LCDBusyFlagModeSet(bool OnOff)
+{
+	_LCDBusyFlagMode = OnOff;
+}
+
+bool HD44780LCD::LCDBusyFlagModeGet(void){return _LCDBusyFlagMode;}
+
+/*!
+	@brief Read the address counter of the LCD
+	@return DDRAM or CGRAM address 0x00-0x7F , -1 for I2C error
+	@note Can be used to check cursor position.
+*/
+int16_t HD44780LCD::LCDReadAddressCounter(void)
+{
+	LCDDeferFlush();
+	LCDWaitReady();
+	int16_t busyAddress = LCDReadBusyAddress();
+	if (busyAddress < 0) {return -1;}
+	return busyAddress & ~LCDBusyFlagMask;
+}
+
+/*!
+	@brief Read the busy flag and address counter through the PCF8574
+	@return BF bit 7 + address counter bits 6-0 , -1 for I2C error
+	@details R/W is set high and data lines are written high so PCF8574 can read them,
+		each nibble is read while enable is high, upper nibble first.
+*/
+int16_t HD44780LCD::LCDReadBusyAddress(void)
+{
+	const uint8_t LCDReadByteOn = 0xF6; // data=1111 enable=1 rw=1 rs =0 1111-X-1-1-0
+	const uint8_t LCDReadByteOff = 0xF2; // data=1111 enable=0 rw=1 rs =0 1111-X-0-1-0
+	const uint8_t LCDLedMask = 0xF7 | (_LCDBackLight & 0x08);
+
+	uint8_t strobe[2] = {(uint8_t)(LCDReadByteOff & LCDLedMask), (uint8_t)(LCDReadByteOn & LCDLedMask)};
+	uint8_t nibbleUpper = 0, nibbleLower = 0;
+
+	if (_LCDPIO != nullptr) {return -1;} // PIO transport is write only
+	if (LCDI2CTransfer(strobe, 2, false) < 1) {return -1;}
+	// an error from here on leaves the controller half way through the read
+	if (LCDI2CTransfer(&nibbleUpper, 1, true) < 1 ||
+		LCDI2CTransfer(strobe, 2, false) < 1 ||
+		LCDI2CTransfer(&nibbleLower, 1, true) < 1 ||
+		LCDI2CTransfer(strobe, 1, false) < 1)
+	{
+		_LCDRecoverPending = true;
+		return -1;
+	}
+
+	return (nibbleUpper & 0xF0) | (nibbleLower >> 4);
+}
+
+/*!
+	@brief One I2C transaction on the I2C block outside LCDI2CWrite, recorded in the trace
+	@param buffer Port bytes to write , or room for the bytes read
+	@param length Number of bytes
+	@param read true = read the PCF8574 port , false = write it
+	@return Return of i2c_read_timeout_us or i2c_write_timeout_us
+	@details For busy flag reads and clock probes, which have no retry or recovery of their own.
+		Reads are recorded with LCDTraceRead and the bytes that came back.
+*/
+int HD44780LCD::LCDI2CTransfer(uint8_t *buffer, size_t length, bool read)
+{
+#if HD44780_LCD_TRACE
+	uint64_t start = time_us_64();
+#endif
+	int returnCode = read ? i2c_read_timeout_us(i2c, _LCDSlaveAddresI2C, buffer, length, false, _LCDI2Cdelay) :
+		i2c_write_timeout_us(i2c, _LCDSlaveAddresI2C, buffer, length, false, _LCDI2Cdelay);
+#if HD44780_LCD_TRACE
+	LCDTraceRecord(buffer, length, start, start, (read ? LCDTraceRead : 0) | (returnCode < 1 ? LCDTraceError : 0));
+#endif
+	return returnCode;
+}
+
+/*!
+	@brief Record that the controller is busy, the next bus write waits until this time
+	@param delayUs Time needed by the last command in uS
+*/
+void HD44780LCD::LCDBusyFor(uint32_t delayUs)
+{
+	absolute_time_t from = get_absolute_time();
+	// PIO writes return before the transfer ends, command starts at end of transfer
+	if (_LCDPIO != nullptr && absolute_time_diff_us(from, _LCDPIODoneAt) > 0) {from = _LCDPIODoneAt;}
+	_LCDBusyUntil = delayed_by_us(from, delayUs);
 }
 
 /*!
@@ -422,11 +1434,31 @@ void HD44780LCD::LCDChangeEntryMode(LCDEntryMode_e newEntryMode)
  */
 void HD44780LCD::LCDDeInit()
 {
+	LCDAsyncDeInit();
+	if (_LCDPIO != nullptr) {LCDPIOEnd();}
+	if (_LCDSharedBus == true) {return;}
 	gpio_set_function(_SDataPin, GPIO_FUNC_NULL);
 	gpio_set_function(_SClkPin, GPIO_FUNC_NULL);
-	i2c_deinit(i2c);
+	if (_LCDPIO == nullptr) {i2c_deinit(i2c);}
 }
 
+/*!
+	@brief Mark the I2C bus as shared with other devices and set up by its owner
+	@param OnOff true = LCDInit and LCDDeInit leave pins and I2C interface alone
+	@note Set by HD44780LCDManager for the displays it holds.
+*/
+void HD44780LCD::LCDSharedBusSet(bool OnOff){_LCDSharedBus = OnOff;}
+
+bool HD44780LCD::LCDSharedBusGet(void){return _LCDSharedBus;}
+
+/*!
+	@brief Get the LCD size set by LCDInit
+	@return number of rows , LCDNumColsGet returns number of columns
+*/
+uint8_t HD44780LCD::LCDNumRowsGet(void){return _NumRowsLCD;}
+
+uint8_t HD44780LCD::LCDNumColsGet(void){return _NumColsLCD;}
+
 
 void HD44780LCD::LCDSerialDebugSet(bool OnOff)
 {
@@ -436,4 +1468,1028 @@ void HD44780LCD::LCDSerialDebugSet(bool OnOff)
 
 bool HD44780LCD::LCDSerialDebugGet(void){return _LCDSerialDebugFlag;}
 
+/*!
+	@brief Turn buffered mode on and off
+	@param OnOff true = text is written to a frame buffer and sent by LCDFlush,
+		false = text is sent to LCD immediately.
+	@note LCDGOTO, LCDMoveCursor, LCDSendString, LCDSendChar, LCDClearLine,
+		LCDClearScreen, LCDPrintCustomChar and print() all write into the frame buffer
+		in buffered mode. Entry modes with display shift are not supported in buffered mode.
+		Turning buffered mode off discards any unflushed changes.
+*/
+void HD44780LCD::LCDBufferModeSet(bool OnOff)
+{
+	if (OnOff == _LCDBufferMode) {return;}
+	_LCDBufferMode = OnOff;
+	if (_LCDBufferMode == true)
+	{
+		if (_LCDShadowValid == true) {
+			memcpy(_LCDFrameBuffer, _LCDShadowBuffer, _LCDDDRAMSize);
+			_LCDBufferDirty = false;
+		} else {
+			// LCD content unknown, first flush redraws the whole display
+			memset(_LCDFrameBuffer, ' ', _LCDDDRAMSize);
+			_LCDBufferDirty = true;
+		}
+		_LCDBufferAddress = 0;
+	}
+}
+
+bool HD44780LCD::LCDBufferModeGet(void){return _LCDBufferMode;}
+
+/*!
+	@brief Send the changes in the frame buffer to the LCD
+	@param maxBytes Most bytes to write on the I2C bus, default no limit
+	@return Number of bytes written on the I2C bus
+	@details Compares frame buffer with the shadow copy of DDRAM and sends
+		only the runs of changed characters, one set address command per run.
+		If the limit is reached the rest stays pending for the next call.
+	@note Cursor is left at end of the last run written.
+*/
+uint16_t HD44780LCD::LCDFlush(uint16_t maxBytes)
+{
+	const uint8_t I2CBytesPerByte = 4; // two nibbles , each with enable high and low
+	uint16_t bytesSent = 0;
+	uint8_t index = 0;
+	bool increment = _LCDEntryMode & LCDEntryIncrementBit;
+	bool pending = false;
+
+	if (_LCDBufferMode == false || _LCDBufferDirty == false) {return 0;}
+	if (_LCDShadowValid == false)
+	{
+		for (uint8_t i = 0; i < _LCDDDRAMSize; i++) {
+			_LCDShadowBuffer[i] = ~_LCDFrameBuffer[i];
+		}
+		_LCDShadowValid = true;
+	}
+	// commands queued in deferred mode go out first and count against the limit
+	if (_LCDDeferCount > 0) {bytesSent += LCDDeferEmit(false, false);}
+
+	while (index < _LCDDDRAMSize)
+	{
+		if (_LCDFrameBuffer[index] == _LCDShadowBuffer[index]) {
+			index++;
+			continue;
+		}
+		// find the run of changed characters, runs do not cross a DDRAM line
+		uint8_t runStart = index;
+		uint8_t lineEnd = (index < _LCDDDRAMLineSize) ? _LCDDDRAMLineSize : _LCDDDRAMSize;
+		while (index < lineEnd && _LCDFrameBuffer[index] != _LCDShadowBuffer[index]) {
+			index++;
+		}
+		// cut the run to fit the byte limit, the cut off part stays changed
+		uint8_t address = LCDIndexToAddress(runStart);
+		bool atAddress = (increment == true && _LCDCursorKnown == true && _LCDCursorAddress == address);
+		int32_t budget = (maxBytes - bytesSent) / I2CBytesPerByte - (atAddress ? 0 : 1);
+		if (budget <= 0) {
+			pending = true;
+			break;
+		}
+		if (index - runStart > budget) {
+			pending = true;
+			increment ? (index = runStart + budget) : (runStart = index - budget);
+		}
+		// Address counter decrements in entry modes one and two, so write run backwards
+		if (increment == true) {
+			LCDSendDataBuffer(&_LCDFrameBuffer[runStart], index - runStart,
+				atAddress ? 0 : (LCDLineAddressOne | address));
+		} else {
+			uint8_t reversed[_LCDDDRAMLineSize];
+			for (uint8_t i = 0; i < index - runStart; i++) {
+				reversed[i] = _LCDFrameBuffer[index - 1 - i];
+			}
+			LCDSendDataBuffer(reversed, index - runStart,
+				LCDLineAddressOne | LCDIndexToAddress(index - 1));
+		}
+		bytesSent += I2CBytesPerByte * ((atAddress ? 0 : 1) + index - runStart);
+		if (pending == true) {break;}
+	}
+	_LCDBufferDirty = pending;
+	return bytesSent;
+}
+
+/*!
+	@brief Check for frame buffer changes not yet sent by LCDFlush
+	@return true if a flush is pending
+*/
+bool HD44780LCD::LCDBufferDirtyGet(void){return _LCDBufferDirty;}
+
+/*!
+	@brief Write a character to LCD or to the frame buffer if buffered mode is on
+	@param data Character to write
+*/
+void HD44780LCD::LCDPutChar(uint8_t data)
+{
+	if (_LCDBufferMode == false)
+	{
+		LCDSendData(data);
+		return;
+	}
+	int8_t index = LCDAddressToIndex(_LCDBufferAddress);
+	if (index >= 0 && _LCDFrameBuffer[index] != data)
+	{
+		_LCDFrameBuffer[index] = data;
+		_LCDBufferDirty = true;
+	}
+	bool increment = _LCDEntryMode & LCDEntryIncrementBit;
+	_LCDBufferAddress = LCDAddressStep(_LCDBufferAddress, increment);
+}
+
+/*!
+	@brief Update tracked address counter and entry mode for a command sent to LCD
+	@param cmd The command byte
+*/
+void __not_in_flash_func(HD44780LCD::LCDTrackCmd)(uint8_t cmd)
+{
+#if HD44780_LCD_STATS
+	uint32_t statsLock = LCDStatsLock();
+	_LCDStats.commands++;
+	LCDStatsUnlock(statsLock);
+#endif
+	if (cmd & 0x80) { // set DDRAM address
+		_LCDCursorAddress = cmd & ~LCDLineAddressOne;
+		_LCDCursorKnown = true;
+		_LCDCursorRestore = false;
+		_LCDCGRAMMode = false;
+	} else if (cmd & 0x40) { // set CGRAM address, counter no longer points at DDRAM
+		_LCDCursorRestore = _LCDCursorKnown || _LCDCursorRestore;
+		_LCDCursorKnown = false;
+		_LCDCGRAMMode = true;
+		_LCDCGRAMAddress = cmd & 0x3F;
+	} else if (cmd & 0x20) { // function set
+	} else if (cmd & 0x10) { // cursor or display shift, only cursor shift moves address counter
+		if (cmd & 0x08) {
+			_LCDDisplayShift = (_LCDDisplayShift + ((cmd & 0x04) ? 1 : -1)) % _LCDDDRAMLineSize;
+		} else if (_LCDCGRAMMode == true) {
+			_LCDCGRAMAddress = (_LCDCGRAMAddress + ((cmd & 0x04) ? 1 : -1)) & 0x3F;
+		} else {
+			_LCDCursorAddress = LCDAddressStep(_LCDCursorAddress, cmd & 0x04);
+		}
+	} else if (cmd & 0x08) { // display control
+		_LCDDisplayControl = cmd;
+	} else if (cmd & 0x04) { // entry mode
+		_LCDEntryMode = (LCDEntryMode_e)cmd;
+	} else if (cmd & 0x02) { // home, also undoes display shift
+		_LCDCursorAddress = 0;
+		_LCDCursorKnown = true;
+		_LCDCursorRestore = false;
+		_LCDCGRAMMode = false;
+		_LCDDisplayShift = 0;
+	} else if (cmd & 0x01) { // clear, also sets entry mode to increment
+		_LCDCursorAddress = 0;
+		_LCDCursorKnown = true;
+		_LCDCursorRestore = false;
+		_LCDCGRAMMode = false;
+		_LCDDisplayShift = 0;
+		_LCDEntryMode = (LCDEntryMode_e)(_LCDEntryMode | LCDEntryIncrementBit);
+		memset(_LCDShadowBuffer, ' ', _LCDDDRAMSize);
+		_LCDShadowValid = true;
+	}
+}
+
+/*!
+	@brief Update tracked address counter for data bytes written to DDRAM
+	@param count Number of data bytes
+*/
+void __not_in_flash_func(HD44780LCD::LCDTrackData)(size_t count)
+{
+#if HD44780_LCD_STATS
+	uint32_t statsLock = LCDStatsLock();
+	_LCDStats.characters += count;
+	LCDStatsUnlock(statsLock);
+#endif
+	bool increment = _LCDEntryMode & LCDEntryIncrementBit;
+	if (_LCDEntryMode & LCDEntryShiftBit) { // display moves the other way to the cursor
+		_LCDDisplayShift = (_LCDDisplayShift + (increment ? -1 : 1) * (int)(count % _LCDDDRAMLineSize)) % _LCDDDRAMLineSize;
+	}
+	if (_LCDCGRAMMode == true)
+	{
+		_LCDCGRAMAddress = (_LCDCGRAMAddress + (increment ? count : -count)) & 0x3F;
+		return;
+	}
+	if (_LCDCursorKnown == false) {return;}
+	while (count--) {
+		_LCDCursorAddress = LCDAddressStep(_LCDCursorAddress, increment);
+	}
+}
+
+/*!
+	@brief Update the shadow copies of DDRAM and CGRAM with data bytes about to be sent
+	@param data Pointer to the data bytes
+	@param length Number of data bytes
+	@note Call after LCDTrackCmd of any address command and before LCDTrackData.
+		A DDRAM write at an unknown address counter makes the DDRAM shadow invalid.
+*/
+void __not_in_flash_func(HD44780LCD::LCDMirrorData)(const uint8_t *data, size_t length)
+{
+	bool increment = _LCDEntryMode & LCDEntryIncrementBit;
+	if (_LCDCGRAMMode == true)
+	{
+		uint8_t address = _LCDCGRAMAddress;
+		for (size_t i = 0; i < length; i++)
+		{
+			_LCDCGRAMShadow[address] = data[i];
+			_LCDCGRAMUsed |= 1 << (address >> 3);
+			address = (address + (increment ? 1 : -1)) & 0x3F;
+		}
+		return;
+	}
+	if (_LCDCursorKnown == false)
+	{
+		_LCDShadowValid = false;
+		return;
+	}
+	uint8_t address = _LCDCursorAddress;
+	for (size_t i = 0; i < length; i++)
+	{
+		_LCDShadowBuffer[LCDAddressToIndex(address)] = data[i];
+		address = LCDAddressStep(address, increment);
+	}
+}
+
+/*!
+	@brief Check if a character code is in a visible position on the LCD
+	@param character Character code, custom characters 0-7 also match their alias 8-15
+	@return true if it is or may be on screen , false if it is not
+	@note Uses the shadow copy of DDRAM, what the LCD shows now. In buffered mode the frame
+		buffer is checked too, what it shows after the next LCDFlush. When the content or
+		address counter is not tracked, or the display is shifted, every code may be on screen.
+*/
+bool HD44780LCD::LCDCharacterOnScreen(uint8_t character)
+{
+	const uint8_t *buffers[2] = {_LCDShadowBuffer, _LCDBufferMode ? _LCDFrameBuffer : nullptr};
+	bool tracked = _LCDCursorKnown || _LCDCursorRestore || _LCDCGRAMMode;
+
+	if (_LCDShadowValid == false || tracked == false || _LCDDisplayShift != 0) {return true;}
+
+	for (uint8_t row = LCDLineNumberOne; row <= _NumRowsLCD; row++)
+	{
+		for (uint8_t col = 0; col < _NumColsLCD; col++)
+		{
+			int8_t index = LCDAddressToIndex(LCDCellAddressCmd((LCDLineNumber_e)row, col) & ~LCDLineAddressOne);
+			if (index < 0) {continue;}
+			for (const uint8_t *buffer : buffers)
+			{
+				if (buffer == nullptr) {continue;}
+				uint8_t cell = buffer[index];
+				if (cell == character || (character < 16 && cell < 16 && (cell & 0x07) == (character & 0x07))) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+/*!
+	@brief Set frame and shadow buffers to spaces, called after LCD is cleared
+*/
+void HD44780LCD::LCDBufferClear(void)
+{
+	memset(_LCDFrameBuffer, ' ', _LCDDDRAMSize);
+	memset(_LCDShadowBuffer, ' ', _LCDDDRAMSize);
+	_LCDShadowValid = true;
+	_LCDBufferAddress = 0;
+	_LCDBufferDirty = false;
+}
+
+/*!
+	@brief Move a DDRAM address one position, wraps like the HD44780 address counter
+	@param address DDRAM address 0x00-0x27 or 0x40-0x67
+	@param increment true = increment , false = decrement
+	@return the new DDRAM address
+*/
+uint8_t HD44780LCD::LCDAddressStep(uint8_t address, bool increment)
+{
+	if (increment == true) {
+		switch (address) {
+			case 0x27: return 0x40;
+			case 0x67: return 0x00;
+			default: return address + 1;
+		}
+	}
+	switch (address) {
+		case 0x00: return 0x67;
+		case 0x40: return 0x27;
+		default: return address - 1;
+	}
+}
+
+/*!
+	@brief Convert DDRAM address to buffer index
+	@param address DDRAM address 0x00-0x27 or 0x40-0x67
+	@return buffer index 0-79 , -1 if address is not in DDRAM
+*/
+int8_t HD44780LCD::LCDAddressToIndex(uint8_t address)
+{
+	uint8_t column = address & 0x3F;
+	if (column >= _LCDDDRAMLineSize || address > 0x7F) {return -1;}
+	return (address & 0x40) ? (_LCDDDRAMLineSize + column) : column;
+}
+
+/*!
+	@brief Convert buffer index to DDRAM address
+	@param index buffer index 0-79
+	@return DDRAM address 0x00-0x27 or 0x40-0x67
+*/
+uint8_t HD44780LCD::LCDIndexToAddress(uint8_t index)
+{
+	return (index < _LCDDDRAMLineSize) ? index : (0x40 + index - _LCDDDRAMLineSize);
+}
+
+// Section : Asynchronous DMA transmit
+
+/*!
+	@brief Start asynchronous mode, claims a DMA channel to feed the I2C TX FIFO
+	@return true for success , false if no DMA channel is free or interrupt mode is on
+	@note Call after LCDInit. Blocking methods wait for the queue to drain before using the bus.
+*/
+bool HD44780LCD::LCDAsyncInit(void)
+{
+	if (_LCDAsyncMode != LCDAsyncOff) {return _LCDAsyncMode == LCDAsyncDMA;}
+	if (_LCDPIO != nullptr) {return false;} // PIO transport is already DMA fed
+	_LCDAsyncDMAChannel = dma_claim_unused_channel(false);
+	if (_LCDAsyncDMAChannel < 0)
+	{
+		if (_LCDSerialDebugFlag == true) {
+			printf("1204 LCDAsyncInit: No free DMA channel.\r\n");
+		}
+		return false;
+	}
+	_LCDAsyncHead = 0;
+	_LCDAsyncTail = 0;
+	_LCDAsyncError = false;
+	_LCDAsyncMode = LCDAsyncDMA;
+	return true;
+}
+
+/*!
+	@brief Stop asynchronous mode, drains the queue and releases the DMA channel or I2C interrupt
+*/
+void HD44780LCD::LCDAsyncDeInit(void)
+{
+	if (_LCDAsyncMode == LCDAsyncOff) {return;}
+	LCDWaitIdle();
+	if (_LCDAsyncMode == LCDAsyncDMA)
+	{
+		dma_channel_unclaim(_LCDAsyncDMAChannel);
+		_LCDAsyncDMAChannel = -1;
+	} else {
+		uint8_t index = i2c_hw_index(i2c);
+		uint irq = (index == 0) ? I2C0_IRQ : I2C1_IRQ;
+		irq_set_enabled(irq, false);
+		irq_remove_handler(irq, (index == 0) ? LCDAsyncIRQHandler0 : LCDAsyncIRQHandler1);
+		i2c_get_hw(i2c)->tx_tl = 0;
+		_LCDAsyncIRQOwner[index] = nullptr;
+	}
+	_LCDAsyncMode = LCDAsyncOff;
+}
+
+/*!
+	@brief Queue a string to be sent to LCD by DMA or interrupt, returns without waiting for the bus
+	@param str Pointer to the char array
+	@return true if queued , false if async mode is off or the queue has not enough room
+	@note Call LCDAsyncPoll from the main loop to keep the transfer going.
+*/
+bool HD44780LCD::LCDSendStringAsync(const char *str)
+{
+	return LCDAsyncQueue((const uint8_t *)str, strlen(str), 0);
+}
+
+/*!
+	@brief Queue a cursor move and a string to be sent to LCD by DMA or interrupt
+	@param str Pointer to the char array
+	@param line row 1-4
+	@param col column 0-15 or 0-19
+	@return true if queued , false if async mode is off or the queue has not enough room
+*/
+bool HD44780LCD::LCDSendStringAsync(const char *str, LCDLineNumber_e line, uint8_t col)
+{
+	uint8_t addressCmd = LCDCellAddressCmd(line, col);
+	if (addressCmd == 0) {return false;}
+	return LCDAsyncQueue((const uint8_t *)str, strlen(str), addressCmd);
+}
+
+/*!
+	@brief Set a function to be called each time the async queue has been fully sent
+	@param callback Pointer to function, nullptr for none
+	@note Called from LCDAsyncPoll, not from an interrupt.
+*/
+void HD44780LCD::LCDAsyncCallbackSet(void (*callback)(void))
+{
+	_LCDAsyncCallback = callback;
+}
+
+/*!
+	@brief Service the async transmit engine, starts the next transfer when the bus is free
+	@return true when queue is empty and the last transfer is complete
+	@note Never blocks, call it regularly from the main loop.
+*/
+bool HD44780LCD::LCDAsyncPoll(void)
+{
+	if (_LCDAsyncMode == LCDAsyncOff) {return true;}
+	if (_LCDAsyncMode == LCDAsyncIRQ) {return LCDAsyncIRQPoll();}
+	i2c_hw_t *i2cHardware = i2c_get_hw(i2c);
+
+	if (i2cHardware->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+	{
+		// NACK or arbitration lost, hardware flushed the FIFO, drop the rest of this transfer
+		dma_channel_abort(_LCDAsyncDMAChannel);
+		(void)i2cHardware->clr_tx_abrt;
+		_LCDAsyncError = true;
+		_LCDRecoverPending = true; // next blocking write resyncs the LCD
+#if HD44780_LCD_STATS
+		uint32_t statsLock = LCDStatsLock();
+		_LCDStats.nacks++;
+		LCDStatsUnlock(statsLock);
+#endif
+		if (_LCDSerialDebugFlag == true) {
+			printf("1205 LCDAsyncPoll: I2C transfer aborted.\r\n");
+		}
+	}
+
+	if (dma_channel_is_busy(_LCDAsyncDMAChannel)) {return false;}
+	if (!time_reached(_LCDBusyUntil)) {return false;}
+	// Wait for the I2C block to send the last byte and stop before changing target
+	if (!(i2cHardware->status & I2C_IC_STATUS_TFE_BITS) || (i2cHardware->status & I2C_IC_STATUS_ACTIVITY_BITS)) {
+		return false;
+	}
+
+	uint16_t head = _LCDAsyncHead.load(std::memory_order_acquire);
+	uint16_t tail = _LCDAsyncTail.load(std::memory_order_relaxed);
+	if (head == tail)
+	{
+		if (_LCDAsyncPending == true)
+		{
+			_LCDAsyncPending = false;
+			if (_LCDAsyncCallback != nullptr) {_LCDAsyncCallback();}
+		}
+		return true;
+	}
+
+	// Copy next chunk out of the ring, I2C DMA writes 16 bit words, stop bit on last byte
+	uint16_t count = head - tail;
+	if (count > 4 * _LCDI2CBatchSize) {count = 4 * _LCDI2CBatchSize;}
+	for (uint16_t i = 0; i < count; i++) {
+		_LCDAsyncDMABuffer[i] = _LCDAsyncRing[(tail + i) & (_LCDAsyncRingSize - 1)];
+	}
+	_LCDAsyncDMABuffer[count - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+	_LCDAsyncTail.store(tail + count, std::memory_order_release);
+#if HD44780_LCD_STATS
+	uint32_t statsLock = LCDStatsLock();
+	_LCDStats.transactions++;
+	_LCDStats.bytes += count;
+	LCDStatsUnlock(statsLock);
+#endif
+
+	i2cHardware->enable = 0;
+	i2cHardware->tar = _LCDSlaveAddresI2C;
+	i2cHardware->enable = 1;
+
+	dma_channel_config config = dma_channel_get_default_config(_LCDAsyncDMAChannel);
+	channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+	channel_config_set_read_increment(&config, true);
+	channel_config_set_write_increment(&config, false);
+	channel_config_set_dreq(&config, i2c_get_dreq(i2c, true));
+	dma_channel_configure(_LCDAsyncDMAChannel, &config, &i2cHardware->data_cmd,
+		_LCDAsyncDMABuffer, count, true);
+	return false;
+}
+
+/*!
+	@brief Block until the async queue has been fully sent
+*/
+void HD44780LCD::LCDWaitIdle(void)
+{
+	while (LCDAsyncPoll() == false) {
+		tight_loop_contents();
+	}
+}
+
+/*!
+	@brief Get and clear the async error flag
+	@return true if an async I2C transfer was aborted since the last call
+*/
+bool HD44780LCD::LCDAsyncErrorGet(void)
+{
+	bool error = _LCDAsyncError;
+	_LCDAsyncError = false;
+	return error;
+}
+
+/*!
+	@brief Encode data bytes into the async ring buffer and start sending
+	@param data Pointer to the data bytes
+	@param length Number of data bytes
+	@param addressCmd Optional command byte queued ahead of the data, 0 for none.
+	@return true if queued , false if async mode is off or the ring has not enough room
+*/
+bool HD44780LCD::LCDAsyncQueue(const uint8_t *data, size_t length, uint8_t addressCmd)
+{
+	if (_LCDAsyncMode == LCDAsyncOff) {return false;}
+	if (_LCDDeferCount > 0) {LCDDeferEmit(addressCmd != 0, false);}
+	size_t needed = 4 * (length + (addressCmd != 0 ? 1 : 0));
+	uint16_t head = _LCDAsyncHead.load(std::memory_order_relaxed); // published once the bytes are in, the interrupt reads it
+	size_t freeSpace = _LCDAsyncRingSize - (uint16_t)(head - _LCDAsyncTail.load(std::memory_order_acquire));
+	if (needed > freeSpace) {return false;}
+
+	uint8_t encoded[4];
+	if (addressCmd == 0 && _LCDCursorRestore == true) {
+		addressCmd = LCDLineAddressOne | _LCDCursorAddress; // back to DDRAM after a CGRAM write
+	}
+	if (addressCmd != 0) {LCDTrackCmd(addressCmd);}
+	LCDMirrorData(data, length);
+	LCDTrackData(length);
+	if (addressCmd != 0)
+	{
+		LCDEncodeByte(addressCmd, false, encoded);
+		for (uint8_t i = 0; i < 4; i++) {
+			_LCDAsyncRing[head++ & (_LCDAsyncRingSize - 1)] = encoded[i];
+		}
+	}
+	while (length--)
+	{
+		LCDEncodeByte(*data++, true, encoded);
+		for (uint8_t i = 0; i < 4; i++) {
+			_LCDAsyncRing[head++ & (_LCDAsyncRingSize - 1)] = encoded[i];
+		}
+	}
+	_LCDAsyncHead.store(head, std::memory_order_release);
+#if HD44780_LCD_TRACE
+	if (_LCDTraceMode == true)
+	{
+		uint8_t queued[_LCDAsyncRingSize];
+		uint16_t start = head - needed;
+		for (size_t i = 0; i < needed; i++) {
+			queued[i] = _LCDAsyncRing[(start + i) & (_LCDAsyncRingSize - 1)];
+		}
+		uint64_t queueTime = time_us_64();
+		LCDTraceRecord(queued, needed, queueTime, queueTime, LCDTraceAsync);
+	}
+#endif
+	_LCDAsyncPending = true;
+	LCDAsyncPoll();
+	return true;
+}
+
+// Section : Interrupt driven transmit
+
+HD44780LCD *HD44780LCD::_LCDAsyncIRQOwner[2] = {nullptr, nullptr};
+
+/*!
+	@brief Start asynchronous mode without DMA, the I2C TX empty interrupt refills the TX FIFO
+	@return true for success , false if the I2C interrupt already has a handler or DMA mode is on
+	@details Uses the same queue as LCDAsyncInit, LCDSendStringAsync returns at once and
+		the interrupt moves the queue into the 16 entry FIFO, a STOP every batch size bytes.
+		An abort or NACK drops the queue and is latched, the next LCDAsyncPoll or blocking
+		call sets LCDAsyncErrorGet and resyncs the LCD, see LCDRecover.
+	@note Call after LCDInit. One LCD per I2C block can use the interrupt,
+		call LCDAsyncPoll from the main loop to start sending after slow commands.
+*/
+bool HD44780LCD::LCDAsyncIRQInit(void)
+{
+	if (_LCDAsyncMode != LCDAsyncOff) {return _LCDAsyncMode == LCDAsyncIRQ;}
+	if (_LCDPIO != nullptr) {return false;} // PIO transport has no I2C block
+	uint8_t index = i2c_hw_index(i2c);
+	uint irq = (index == 0) ? I2C0_IRQ : I2C1_IRQ;
+	if (_LCDAsyncIRQOwner[index] != nullptr || irq_get_exclusive_handler(irq) != nullptr || irq_has_shared_handler(irq))
+	{
+		if (_LCDSerialDebugFlag == true) {
+			printf("1207 LCDAsyncIRQInit: I2C interrupt already in use.\r\n");
+		}
+		return false;
+	}
+	i2c_hw_t *i2cHardware = i2c_get_hw(i2c);
+	i2cHardware->intr_mask = 0;
+	i2cHardware->tx_tl = _LCDAsyncFIFODepth / 2; // refill at half empty
+	_LCDAsyncIRQOwner[index] = this;
+	_LCDAsyncIRQAbort = false;
+	_LCDAsyncHead = 0;
+	_LCDAsyncTail = 0;
+	_LCDAsyncError = false;
+	_LCDAsyncMode = LCDAsyncIRQ;
+	irq_set_exclusive_handler(irq, (index == 0) ? LCDAsyncIRQHandler0 : LCDAsyncIRQHandler1);
+	irq_set_enabled(irq, true);
+	return true;
+}
+
+/*!
+	@brief LCDAsyncPoll for interrupt mode, takes latched errors and starts sending
+	@return true when queue is empty and the last transaction is complete
+	@details The interrupt masks itself when the queue is empty. Once the bus is idle the
+		abort interrupt is masked too, so it does not take aborts of blocking writes,
+		and queued bytes are started with the target address set.
+*/
+bool HD44780LCD::LCDAsyncIRQPoll(void)
+{
+	i2c_hw_t *i2cHardware = i2c_get_hw(i2c);
+	bool idle = (i2cHardware->status & I2C_IC_STATUS_TFE_BITS) && !(i2cHardware->status & I2C_IC_STATUS_ACTIVITY_BITS);
+
+	uint32_t interrupts = save_and_disable_interrupts();
+	bool sending = i2cHardware->intr_mask & I2C_IC_INTR_MASK_M_TX_EMPTY_BITS;
+	if (sending == false && idle == true && i2cHardware->intr_mask != 0)
+	{
+		i2cHardware->intr_mask = 0;
+		if (i2cHardware->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+		{
+			(void)i2cHardware->clr_tx_abrt;
+			_LCDAsyncTail.store(_LCDAsyncHead.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			_LCDAsyncIRQAbort.store(true, std::memory_order_relaxed);
+		}
+	}
+	// load and store, not exchange , the M0+ has no atomic read-modify-write and interrupts are off
+	bool aborted = _LCDAsyncIRQAbort.load(std::memory_order_relaxed);
+	_LCDAsyncIRQAbort.store(false, std::memory_order_relaxed);
+	bool empty = (_LCDAsyncHead.load(std::memory_order_relaxed) == _LCDAsyncTail.load(std::memory_order_acquire));
+	restore_interrupts(interrupts);
+
+	if (aborted == true)
+	{
+		_LCDAsyncError = true;
+		_LCDRecoverPending = true; // next blocking write resyncs the LCD
+#if HD44780_LCD_STATS
+		uint32_t statsLock = LCDStatsLock();
+		_LCDStats.nacks++;
+		LCDStatsUnlock(statsLock);
+#endif
+		if (_LCDSerialDebugFlag == true) {
+			printf("1205 LCDAsyncPoll: I2C transfer aborted.\r\n");
+		}
+	}
+	if (sending == true || idle == false) {return false;}
+	if (!time_reached(_LCDBusyUntil)) {return false;}
+
+	if (empty == true)
+	{
+		if (_LCDAsyncPending == true)
+		{
+			_LCDAsyncPending = false;
+			if (_LCDAsyncCallback != nullptr) {_LCDAsyncCallback();}
+		}
+		return true;
+	}
+
+	i2cHardware->enable = 0;
+	i2cHardware->tar = _LCDSlaveAddresI2C;
+	i2cHardware->enable = 1;
+	_LCDAsyncIRQBatch.store(0, std::memory_order_relaxed);
+	i2cHardware->intr_mask = I2C_IC_INTR_MASK_M_TX_EMPTY_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+	return false;
+}
+
+/*!
+	@brief I2C interrupt service, refills the TX FIFO from the queue
+	@details On an abort the hardware has flushed the FIFO, the queue is dropped and the
+		abort latched for LCDAsyncPoll, LCDRecover restores the dropped text from the shadow copy.
+*/
+void __not_in_flash_func(HD44780LCD::LCDAsyncIRQService)(void)
+{
+	i2c_hw_t *i2cHardware = i2c_get_hw(i2c);
+	if (i2cHardware->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+	{
+		(void)i2cHardware->clr_tx_abrt;
+		i2cHardware->intr_mask = 0;
+		_LCDAsyncTail.store(_LCDAsyncHead.load(std::memory_order_relaxed), std::memory_order_release);
+		_LCDAsyncIRQAbort.store(true, std::memory_order_relaxed);
+		return;
+	}
+
+	// working copies , written back once , the M0+ has no atomic read-modify-write
+	uint16_t head = _LCDAsyncHead.load(std::memory_order_acquire);
+	uint16_t tail = _LCDAsyncTail.load(std::memory_order_relaxed);
+	uint16_t batch = _LCDAsyncIRQBatch.load(std::memory_order_relaxed);
+	while (tail != head && i2cHardware->txflr < _LCDAsyncFIFODepth)
+	{
+		uint16_t word = _LCDAsyncRing[tail++ & (_LCDAsyncRingSize - 1)];
+		// STOP at the batch size or the end of the queue , each byte is a port write on its own
+		if (++batch == 4 * _LCDI2CBatchSize || tail == head)
+		{
+			word |= I2C_IC_DATA_CMD_STOP_BITS;
+#if HD44780_LCD_STATS
+			uint32_t statsLock = LCDStatsLock();
+			_LCDStats.transactions++;
+			_LCDStats.bytes += batch;
+			LCDStatsUnlock(statsLock);
+#endif
+			batch = 0;
+		}
+		i2cHardware->data_cmd = word;
+	}
+	_LCDAsyncIRQBatch.store(batch, std::memory_order_relaxed);
+	_LCDAsyncTail.store(tail, std::memory_order_release);
+	// queue sent , keep the abort interrupt until LCDAsyncPoll sees the bus idle
+	if (tail == head) {i2cHardware->intr_mask = I2C_IC_INTR_MASK_M_TX_ABRT_BITS;}
+}
+
+void __not_in_flash_func(HD44780LCD::LCDAsyncIRQHandler0)(void)
+{
+	_LCDAsyncIRQOwner[0]->LCDAsyncIRQService();
+}
+
+void __not_in_flash_func(HD44780LCD::LCDAsyncIRQHandler1)(void)
+{
+	_LCDAsyncIRQOwner[1]->LCDAsyncIRQService();
+}
+
+// Section : PIO transport
+
+/*!
+	@brief Load the I2C program into the PIO and start the state machine
+	@return false if the pins or program space are not usable, or the PCF8574 does not ACK
+	@note Called by LCD_I2C_ON. Falls back to the CPU feeding the FIFO if no DMA channel is free.
+*/
+bool HD44780LCD::LCDPIOBegin(void)
+{
+	if (_SClkPin != _SDataPin + 1 || !pio_can_add_program(_LCDPIO, &hd44780_i2c_program))
+	{
+		if (_LCDSerialDebugFlag == true) {
+			printf("1206 LCDPIOBegin: SCLK pin must be SDA pin + 1 and PIO needs room for program.\r\n");
+		}
+		return false;
+	}
+	// the SDK panics on a second claim , the state machine may belong to other code
+	if (pio_sm_is_claimed(_LCDPIO, _LCDPIOStateMachine))
+	{
+		if (_LCDSerialDebugFlag == true) {
+			printf("1207 LCDPIOBegin: state machine %u already claimed.\r\n", _LCDPIOStateMachine);
+		}
+		return false;
+	}
+	pio_sm_claim(_LCDPIO, _LCDPIOStateMachine);
+	_LCDPIOClaimed = true;
+	_LCDPIOOffset = pio_add_program(_LCDPIO, &hd44780_i2c_program);
+	hd44780_i2c_program_init(_LCDPIO, _LCDPIOStateMachine, _LCDPIOOffset, _SDataPin, _CLKSpeed);
+	_LCDPIODMAChannel = dma_claim_unused_channel(false);
+
+	// check connection, port write with enable high as at power on, no strobe while the controller starts
+	uint8_t port = 0x04;
+	LCDPIOWrite(&port, 1);
+	if (LCDPIOWaitIdle() == false)
+	{
+		if (_LCDSerialDebugFlag == true) {
+			printf("1201 LCDPIOBegin: Check Connection, no ACK from 0x%02X\r\n", _LCDSlaveAddresI2C);
+		}
+		LCDPIOEnd();
+		return false;
+	}
+	return true;
+}
+
+/*!
+	@brief Stop the state machine and release the PIO and DMA resources
+	@note Does nothing unless LCDPIOBegin claimed the state machine.
+*/
+void HD44780LCD::LCDPIOEnd(void)
+{
+	if (_LCDPIOClaimed == false) {return;}
+	LCDPIOWaitIdle();
+	pio_sm_set_enabled(_LCDPIO, _LCDPIOStateMachine, false);
+	pio_remove_program(_LCDPIO, &hd44780_i2c_program, _LCDPIOOffset);
+	pio_sm_unclaim(_LCDPIO, _LCDPIOStateMachine);
+	_LCDPIOClaimed = false;
+	if (_LCDPIODMAChannel >= 0)
+	{
+		dma_channel_unclaim(_LCDPIODMAChannel);
+		_LCDPIODMAChannel = -1;
+	}
+}
+
+/*!
+	@brief Start one I2C write transaction on the PIO transport
+	@param buffer Pointer to the encoded PCF8574 port bytes
+	@param length Number of bytes, up to 4 * _LCDI2CBatchMax
+	@return false if this or the previous transaction failed
+	@details Returns once the words are handed to DMA , the transfer runs without the CPU.
+		A NACK is found when the next transaction starts and reported by its return value.
+*/
+bool __not_in_flash_func(HD44780LCD::LCDPIOWrite)(const uint8_t *buffer, size_t length)
+{
+	bool lastOk = LCDPIOWaitIdle();
+	if (length == 0 || length > 4 * _LCDI2CBatchMax) {return false;}
+
+	uint32_t *word = _LCDPIOBuffer;
+	*word++ = LCDPIOEncode(_LCDSlaveAddresI2C << 1, true, false);
+	for (size_t i = 0; i < length; i++)
+	{
+		*word++ = LCDPIOEncode(buffer[i], false, i == length - 1);
+	}
+	uint32_t count = word - _LCDPIOBuffer;
+#if HD44780_LCD_STATS
+	uint32_t statsLock = LCDStatsLock();
+	_LCDStats.transactions++;
+	_LCDStats.bytes += length;
+	LCDStatsUnlock(statsLock);
+#endif
+
+	if (_LCDPIODMAChannel >= 0)
+	{
+		dma_channel_config config = dma_channel_get_default_config(_LCDPIODMAChannel);
+		channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+		channel_config_set_read_increment(&config, true);
+		channel_config_set_write_increment(&config, false);
+		channel_config_set_dreq(&config, pio_get_dreq(_LCDPIO, _LCDPIOStateMachine, true));
+		dma_channel_configure(_LCDPIODMAChannel, &config, &_LCDPIO->txf[_LCDPIOStateMachine],
+			_LCDPIOBuffer, count, true);
+	} else {
+		for (uint32_t i = 0; i < count; i++) {
+			pio_sm_put_blocking(_LCDPIO, _LCDPIOStateMachine, _LCDPIOBuffer[i]);
+		}
+	}
+	_LCDPIODoneAt = make_timeout_time_us((count * 9 * 1000) / _CLKSpeed + 1); // 9 clocks per byte
+	return lastOk;
+}
+
+/*!
+	@brief Wait for the PIO transaction in progress to finish
+	@return false if it was not acknowledged or timed out
+	@details Done when the last word is in the FIFO and the state machine has stalled
+		on an empty FIFO. On a NACK the state machine sends STOP and waits on its IRQ,
+		the rest of the transaction is dropped before the IRQ is cleared.
+*/
+bool __not_in_flash_func(HD44780LCD::LCDPIOWaitIdle)(void)
+{
+	const uint32_t stallMask = 1u << (PIO_FDEBUG_TXSTALL_LSB + _LCDPIOStateMachine);
+	absolute_time_t timeout = make_timeout_time_us(_LCDI2Cdelay);
+	bool fed = false;
+	bool ok = true;
+
+	while (true)
+	{
+		if (fed == false && !(_LCDPIODMAChannel >= 0 && dma_channel_is_busy(_LCDPIODMAChannel)))
+		{
+			fed = true;
+			_LCDPIO->fdebug = stallMask; // write 1 to clear , set again once FIFO runs dry
+		}
+		if (fed == true && (_LCDPIO->fdebug & stallMask)) {break;}
+		bool nack = pio_interrupt_get(_LCDPIO, _LCDPIOStateMachine);
+		if (nack == true || time_reached(timeout))
+		{
+			if (_LCDPIODMAChannel >= 0) {dma_channel_abort(_LCDPIODMAChannel);}
+			pio_sm_clear_fifos(_LCDPIO, _LCDPIOStateMachine);
+			if (nack == true) {
+				pio_interrupt_clear(_LCDPIO, _LCDPIOStateMachine);
+			} else { // bus stuck , start program again
+				pio_sm_restart(_LCDPIO, _LCDPIOStateMachine);
+				pio_sm_exec(_LCDPIO, _LCDPIOStateMachine,
+					pio_encode_jmp(_LCDPIOOffset + hd44780_i2c_offset_entry_point));
+			}
+#if HD44780_LCD_STATS
+			uint32_t statsLock = LCDStatsLock();
+			nack ? _LCDStats.nacks++ : _LCDStats.timeouts++;
+			LCDStatsUnlock(statsLock);
+#endif
+			if (ok == true && _LCDSerialDebugFlag == true) {
+				printf("1205 LCDPIOWaitIdle: I2C %s\r\n", nack ? "NACK" : "timeout");
+			}
+			ok = false;
+			timeout = make_timeout_time_us(_LCDI2Cdelay);
+		}
+		tight_loop_contents();
+	}
+	return ok;
+}
+
+/*!
+	@brief Check which transport is in use
+	@return true = PIO state machine , false = I2C block
+*/
+bool HD44780LCD::LCDPIOModeGet(void){return _LCDPIO != nullptr;}
+
+// Section : Deferred commands
+
+/*!
+	@brief Turn deferred command mode on and off
+	@param OnOff true = set address, cursor and display shift, display control and entry mode
+		commands are queued and folded into as few commands as possible before sending.
+		false = commands are sent at once, any queued commands are sent first.
+	@details The queue is sent by the next data write, slow or CGRAM command, read of
+		the address counter, LCDDeferFlush or when it is full. Folding rules :
+		-# Cursor moves and set address commands become one set address command,
+			left as net cursor moves only when the address counter is not known.
+		-# Display shifts left and right cancel, the net shift is sent the shorter way round.
+		-# Only the last display control and last entry mode commands are sent.
+		-# Address commands are dropped before a data write with its own address,
+			address and display shift commands before a clear or home.
+	@note Stats count commands when they are queued.
+*/
+void HD44780LCD::LCDDeferModeSet(bool OnOff)
+{
+	if (OnOff == false) {LCDDeferFlush();}
+	_LCDDeferMode = OnOff;
+}
+
+bool HD44780LCD::LCDDeferModeGet(void){return _LCDDeferMode;}
+
+/*!
+	@brief Fold and send any queued commands now
+*/
+void HD44780LCD::LCDDeferFlush(void)
+{
+	if (_LCDDeferCount > 0) {LCDDeferEmit(false, false);}
+}
+
+/*!
+	@brief Queue a command in deferred mode
+	@param cmd The command byte
+	@return true if queued , false if it must be sent now, the queue is sent first
+*/
+bool HD44780LCD::LCDDeferQueue(uint8_t cmd)
+{
+	bool deferrable = (cmd & 0x80) || (cmd & 0xF0) == 0x10 || (cmd & 0xF8) == 0x08 || (cmd & 0xFC) == 0x04;
+	if (deferrable == false)
+	{
+		// clear and home reset address and display shift, CGRAM address replaces DDRAM address
+		bool clearOrHome = (cmd & 0xFC) == 0;
+		bool addressDead = clearOrHome || (cmd & 0xC0) == 0x40;
+		if (_LCDDeferCount > 0) {LCDDeferEmit(addressDead, clearOrHome);}
+		return false;
+	}
+	if (_LCDDeferCount == _LCDDeferMax) {LCDDeferEmit(false, false);}
+	_LCDDeferQueue[_LCDDeferCount++] = cmd;
+	return true;
+}
+
+/*!
+	@brief Fold the queued commands and send them in one transaction per batch
+	@param addressDead true = next command sets the address counter, drop address commands
+	@param shiftDead true = next command resets the display shift, drop display shifts
+	@details The commands are already in the tracked state, so the folded commands are
+		not tracked again. When the address counter is known the tracked address is the
+		result of the queued address commands.
+	@return Number of bytes written on the I2C bus
+*/
+uint16_t HD44780LCD::LCDDeferEmit(bool addressDead, bool shiftDead)
+{
+	const uint8_t LCDMoveCursorLeft = 0x10;
+	const uint8_t LCDMoveCursorRight = 0x14;
+	const uint8_t LCDShiftLeft = 0x18;
+	const uint8_t LCDShiftRight = 0x1C;
+	uint8_t displayControl = 0;
+	uint8_t entryMode = 0;
+	uint8_t addressCmd = 0;
+	int16_t shift = 0; // net display shift , positive is right
+	int16_t moves = 0; // net cursor moves after the last set address , positive is right
+	bool addressChanged = false;
+
+	for (uint8_t i = 0; i < _LCDDeferCount; i++)
+	{
+		uint8_t cmd = _LCDDeferQueue[i];
+		if (cmd & 0x80) {
+			addressCmd = cmd;
+			moves = 0;
+			addressChanged = true;
+		} else if (cmd & 0x10) {
+			int8_t step = (cmd & 0x04) ? 1 : -1;
+			(cmd & 0x08) ? (shift += step) : (moves += step);
+			addressChanged = addressChanged || !(cmd & 0x08);
+		} else if (cmd & 0x08) {
+			displayControl = cmd;
+		} else {
+			entryMode = cmd;
+		}
+	}
+	_LCDDeferCount = 0;
+
+	uint8_t folded[_LCDDeferMax + 1];
+	uint8_t count = 0;
+	if (displayControl != 0) {folded[count++] = displayControl;}
+	if (entryMode != 0) {folded[count++] = entryMode;}
+	if (shiftDead == false)
+	{
+		shift %= _LCDDDRAMLineSize;
+		if (shift > _LCDDDRAMLineSize / 2) {shift -= _LCDDDRAMLineSize;}
+		if (shift < -_LCDDDRAMLineSize / 2) {shift += _LCDDDRAMLineSize;}
+		for (; shift > 0; shift--) {folded[count++] = LCDShiftRight;}
+		for (; shift < 0; shift++) {folded[count++] = LCDShiftLeft;}
+	}
+	if (addressDead == false && addressChanged == true)
+	{
+		if (_LCDCursorKnown == true && _LCDCGRAMMode == false) {
+			folded[count++] = LCDLineAddressOne | _LCDCursorAddress;
+		} else {
+			// cursor moves wrap round 80 DDRAM or 64 CGRAM addresses
+			const int16_t addressPositions = (_LCDCGRAMMode == true) ? sizeof(_LCDCGRAMShadow) : _LCDDDRAMSize;
+			if (addressCmd != 0) {folded[count++] = addressCmd;}
+			moves %= addressPositions;
+			if (moves > addressPositions / 2) {moves -= addressPositions;}
+			if (moves < -addressPositions / 2) {moves += addressPositions;}
+			for (; moves > 0; moves--) {folded[count++] = LCDMoveCursorRight;}
+			for (; moves < 0; moves++) {folded[count++] = LCDMoveCursorLeft;}
+		}
+	}
+
+	uint8_t *nextByte = _LCDI2CBuffer;
+	for (uint8_t i = 0; i < count; i++)
+	{
+		LCDEncodeByte(folded[i], false, nextByte);
+		nextByte += 4;
+		if (nextByte == _LCDI2CBuffer + (4 * _LCDI2CBatchSize) || i == count - 1)
+		{
+			LCDI2CWrite(_LCDI2CBuffer, nextByte - _LCDI2CBuffer);
+			nextByte = _LCDI2CBuffer;
+		}
+	}
+	return 4 * count;
+}
+
 // **** EOF ****
@@ -0,0 +1,169 @@
+/*!
+	@file     HD44780_LCD_PCF8574_Coro.cpp
+	@author   Gavin Lyons
+	@brief    C++20 coroutine API for HD44780 LCD, executor and awaitable LCD operations.
+*/
+
+// Section : Includes
+#include "../../include/hd44780/HD44780_LCD_PCF8574_Coro.hpp"
+
+// Section : Executor
+
+/*!
+	@brief Destructor, destroys the tasks still running
+*/
+HD44780LCDExecutor::~HD44780LCDExecutor()
+{
+	for (uint8_t index = 0; index < LCDExecutorMaxTasks; index++)
+	{
+		if (_tasks[index]) {_tasks[index].destroy();}
+	}
+}
+
+/*!
+	@brief Add a task, it first runs on the next poll
+	@param task Task returned by a coroutine function, the executor takes it over
+	@return false if LCDExecutorMaxTasks are running , the task is destroyed
+*/
+bool HD44780LCDExecutor::LCDExecutorSpawn(HD44780LCDTask &&task)
+{
+	if (_count >= LCDExecutorMaxTasks || !task._handle) {return false;}
+	for (uint8_t index = 0; index < LCDExecutorMaxTasks; index++)
+	{
+		if (_tasks[index]) {continue;}
+		_tasks[index] = task._handle;
+		task._handle = nullptr;
+		_tasks[index].promise().executor = this;
+		_count++;
+		return true;
+	}
+	return false;
+}
+
+/*!
+	@brief Step waiting operations and resume tasks that can go on, never waits
+	@param nowUs Current time in uS, time_us_64() for example
+	@return Number of tasks still running
+	@details Tasks run in slot order until they suspend or finish, finished tasks are destroyed.
+*/
+uint8_t HD44780LCDExecutor::LCDExecutorPoll(uint64_t nowUs)
+{
+	_nowUs = nowUs;
+	for (uint8_t index = 0; index < LCDExecutorMaxTasks; index++)
+	{
+		std::coroutine_handle<HD44780LCDTask::promise_type> task = _tasks[index];
+		if (!task) {continue;}
+		HD44780LCDTask::promise_type &promise = task.promise();
+		if (promise.waiting != nullptr)
+		{
+			if (promise.waiting->LCDAwaitStep(nowUs) == false) {continue;}
+			promise.waiting = nullptr;
+		}
+		task.resume();
+		if (task.done())
+		{
+			task.destroy();
+			_tasks[index] = nullptr;
+			_count--;
+		}
+	}
+	return _count;
+}
+
+uint8_t HD44780LCDExecutor::LCDExecutorCountGet(void){return _count;}
+
+/*!
+	@brief Time of the poll running the tasks
+	@return nowUs of the running or last LCDExecutorPoll
+*/
+uint64_t HD44780LCDExecutor::LCDExecutorNowGet(void){return _nowUs;}
+
+// Section : Awaitable operations
+
+/*!
+	@brief Clear the screen
+	@return Awaitable, finished when the controller has done the clear
+	@note Clears the frame buffer too in buffered mode, see LCDClearScreenCmd.
+*/
+HD44780LCDAwait::LCDClearAwaiter HD44780LCDAwait::clear(void)
+{
+	return LCDClearAwaiter(_lcd);
+}
+
+/*!
+	@brief Replace a row, only the changed characters are sent
+	@param line Row 1-4
+	@param text Text for the row, must stay valid until the write finishes
+	@param align LCDAlignLeft, LCDAlignRight or LCDAlignCenter
+	@param maxBytes Most bus bytes per step in buffered mode
+	@return Awaitable, finished when the row is on the screen
+	@details Unbuffered the row is written in one step by LCDWriteLine.
+		Buffered the frame buffer is updated and flushed in steps of maxBytes.
+*/
+HD44780LCDAwait::LCDWriteLineAwaiter HD44780LCDAwait::writeLine(HD44780LCD::LCDLineNumber_e line,
+	std::string_view text, HD44780LCD::LCDAlign_e align, uint16_t maxBytes)
+{
+	return LCDWriteLineAwaiter(_lcd, line, text, align, maxBytes);
+}
+
+/*!
+	@brief Send the frame buffer changes in buffered mode
+	@param maxBytes Most bus bytes per step, the task suspends between steps
+	@return Awaitable, finished when the frame buffer is on the screen
+*/
+HD44780LCDAwait::LCDFlushAwaiter HD44780LCDAwait::flush(uint16_t maxBytes)
+{
+	return LCDFlushAwaiter(_lcd, maxBytes);
+}
+
+/*!
+	@brief Wait without blocking other tasks
+	@param delayUs Time to wait in uS from the co_await
+	@return Awaitable, finished on the first poll at or after the time
+*/
+HD44780LCDAwait::LCDDelayAwaiter HD44780LCDAwait::delay(uint32_t delayUs)
+{
+	return LCDDelayAwaiter(delayUs);
+}
+
+bool HD44780LCDAwait::LCDClearAwaiter::LCDAwaitStep(uint64_t nowUs)
+{
+	(void)nowUs;
+	if (_lcd.LCDPoll() == false) {return false;}
+	if (_sent == true) {return true;}
+	_lcd.LCDClearScreenCmd(); // records a busy until time instead of blocking
+	_sent = true;
+	return _lcd.LCDPoll();
+}
+
+bool HD44780LCDAwait::LCDFlushAwaiter::LCDAwaitStep(uint64_t nowUs)
+{
+	(void)nowUs;
+	if (_lcd.LCDBufferDirtyGet() == false) {return true;}
+	if (_lcd.LCDPoll() == false) {return false;}
+	_lcd.LCDFlush(_maxBytes);
+	return _lcd.LCDBufferDirtyGet() == false;
+}
+
+bool HD44780LCDAwait::LCDWriteLineAwaiter::LCDAwaitStep(uint64_t nowUs)
+{
+	if (_written == false)
+	{
+		if (_lcd.LCDPoll() == false) {return false;}
+		_lcd.LCDWriteLine(_line, _text, _align);
+		_written = true;
+	}
+	return LCDFlushAwaiter::LCDAwaitStep(nowUs);
+}
+
+bool HD44780LCDAwait::LCDDelayAwaiter::LCDAwaitStep(uint64_t nowUs)
+{
+	if (_started == false)
+	{
+		_untilUs = nowUs + _delayUs;
+		_started = true;
+	}
+	return nowUs >= _untilUs;
+}
+
+// **** EOF ****
@@ -0,0 +1,100 @@
+/*!
+	@file     HD44780_LCD_PCF8574_GlyphCache.cpp
+	@author   Gavin Lyons
+	@brief    CGRAM glyph cache for HD44780 LCD, LRU replacement of the 8 custom character slots.
+*/
+
+// Section : Includes
+#include <string.h>
+#include "../../include/hd44780/HD44780_LCD_PCF8574_GlyphCache.hpp"
+
+/*!
+	@brief Constructor for class HD44780LCDGlyphCache
+	@param lcd The LCD whose CGRAM is managed, no other code should write its CGRAM
+*/
+HD44780LCDGlyphCache::HD44780LCDGlyphCache(HD44780LCD &lcd) : _lcd(lcd)
+{
+	LCDGlyphReset();
+}
+
+// Section : Methods
+
+/*!
+	@brief Get the CGRAM slot holding a glyph, uploading it on a miss
+	@param bitmap Pointer to 8 bytes of glyph data , matched by content
+	@return slot 0-7 to use with LCDPrintCustomChar , -1 if all slots are visible on screen
+*/
+int8_t HD44780LCDGlyphCache::LCDGlyphAcquire(const uint8_t *bitmap)
+{
+	int8_t victim = -1;
+	_useCounter++;
+
+	// Hit on an identical bitmap , always compared so a bitmap changed in place is uploaded again
+	for (uint8_t slot = 0; slot < _LCDGlyphSlots; slot++)
+	{
+		if (_slots[slot].id == nullptr) {continue;}
+		if (memcmp(_slots[slot].bitmap, bitmap, 8) == 0)
+		{
+			_slots[slot].id = bitmap;
+			_slots[slot].lastUse = _useCounter;
+			return slot;
+		}
+	}
+
+	// Miss, take an empty slot or the least recently used one not on screen
+	for (uint8_t slot = 0; slot < _LCDGlyphSlots; slot++)
+	{
+		if (_slots[slot].id == nullptr) {
+			victim = slot;
+			break;
+		}
+		if (_lcd.LCDCharacterOnScreen(slot)) {continue;}
+		if (victim < 0 || _slots[slot].lastUse < _slots[victim].lastUse) {
+			victim = slot;
+		}
+	}
+	if (victim < 0) {return -1;}
+
+	_slots[victim].id = bitmap;
+	_slots[victim].lastUse = _useCounter;
+	memcpy(_slots[victim].bitmap, bitmap, 8);
+	_lcd.LCDCreateCustomChar(victim, _slots[victim].bitmap);
+	_uploads++;
+	return victim;
+}
+
+/*!
+	@brief Print a glyph at the cursor, uploading it to CGRAM if needed
+	@param bitmap Pointer to 8 bytes of glyph data
+	@return true if printed , false if no slot could be freed
+*/
+bool HD44780LCDGlyphCache::LCDGlyphPrint(const uint8_t *bitmap)
+{
+	int8_t slot = LCDGlyphAcquire(bitmap);
+	if (slot < 0) {return false;}
+	_lcd.LCDPrintCustomChar(slot);
+	return true;
+}
+
+/*!
+	@brief Forget all resident glyphs, use after LCD is re-initialised
+*/
+void HD44780LCDGlyphCache::LCDGlyphReset(void)
+{
+	for (uint8_t slot = 0; slot < _LCDGlyphSlots; slot++)
+	{
+		_slots[slot].id = nullptr;
+		_slots[slot].lastUse = 0;
+	}
+}
+
+/*!
+	@brief Number of CGRAM uploads done, each is one I2C transaction of 36 bytes
+	@return upload count
+*/
+uint32_t HD44780LCDGlyphCache::LCDGlyphUploadsGet(void)
+{
+	return _uploads;
+}
+
+// **** EOF ****
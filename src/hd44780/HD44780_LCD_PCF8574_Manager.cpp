@@ -0,0 +1,148 @@
+/*!
+	@file     HD44780_LCD_PCF8574_Manager.cpp
+	@author   Gavin Lyons
+	@brief    Manager for several HD44780 LCDs on one I2C bus, round robin flush with a byte budget.
+*/
+
+// Section : Includes
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "../../include/hd44780/HD44780_LCD_PCF8574_Manager.hpp"
+
+/*!
+	@brief Constructor for class HD44780LCDManager
+	@param i2c_type  I2C instance of port IC20 or I2C1
+	@param CLKspeed I2C Bus Clock speed in KHz.
+	@param SDApin I2C Data pin
+	@param SCLKpin I2C Clock pin
+*/
+HD44780LCDManager::HD44780LCDManager(i2c_inst_t* i2c_type, uint16_t CLKspeed, uint8_t SDApin, uint8_t SCLKpin)
+{
+	_i2c = i2c_type;
+	_CLKSpeed = CLKspeed;
+	_SDataPin = SDApin;
+	_SClkPin = SCLKpin;
+}
+
+// Section : Methods
+
+/*!
+	@brief Set up the I2C pins and interface, once for all displays
+	@return false if I2C init fails
+	@note Call before LCDInit of the displays.
+*/
+bool HD44780LCDManager::LCDManagerBegin(void)
+{
+	gpio_set_function(_SDataPin, GPIO_FUNC_I2C);
+	gpio_set_function(_SClkPin, GPIO_FUNC_I2C);
+	gpio_pull_up(_SDataPin);
+	gpio_pull_up(_SClkPin);
+	if (i2c_init(_i2c, _CLKSpeed * 1000) != _CLKSpeed * 1000) {return false;}
+	_windowStart = time_us_64();
+	return true;
+}
+
+/*!
+	@brief Release the I2C pins and interface, call LCDDeInit of the displays first
+*/
+void HD44780LCDManager::LCDManagerEnd(void)
+{
+	gpio_set_function(_SDataPin, GPIO_FUNC_NULL);
+	gpio_set_function(_SClkPin, GPIO_FUNC_NULL);
+	i2c_deinit(_i2c);
+}
+
+/*!
+	@brief Add a display to the manager
+	@param lcd The display, constructed with the same I2C instance and pins
+	@return index of display , -1 if full
+	@note Sets the display to shared bus and buffered mode, LCDInit of the display follows.
+*/
+int8_t HD44780LCDManager::LCDManagerAdd(HD44780LCD &lcd)
+{
+	if (_count >= LCDManagerMaxDisplays) {return -1;}
+	lcd.LCDSharedBusSet(true);
+	lcd.LCDBufferModeSet(true);
+	_displays[_count].lcd = &lcd;
+	_displays[_count].frames = 0;
+	return _count++;
+}
+
+uint8_t HD44780LCDManager::LCDManagerCountGet(void){return _count;}
+
+/*!
+	@brief Get a display added to the manager
+	@param index display index returned by LCDManagerAdd
+	@return pointer to display , nullptr if index is out of range
+*/
+HD44780LCD *HD44780LCDManager::LCDManagerDisplayGet(uint8_t index)
+{
+	return (index < _count) ? _displays[index].lcd : nullptr;
+}
+
+/*!
+	@brief Flush the displays round robin within a byte budget
+	@param budgetBytes Most bytes to write on the I2C bus this frame, 4 per character or command
+	@return Number of bytes written on the I2C bus
+	@details Starts at the first display with changes the last frame had no budget left for,
+		or one on from where the last frame started if it served them all, so every display
+		with changes is served in turn. A display cut short by the budget is finished after
+		the others. A display frame counts as sent when its frame buffer has no pending
+		changes left.
+*/
+uint16_t HD44780LCDManager::LCDManagerFrame(uint16_t budgetBytes)
+{
+	uint16_t bytesSent = 0;
+	uint8_t served = 0;
+
+	for (; served < _count; served++)
+	{
+		LCDManagerDisplay_t &display = _displays[(_next + served) % _count];
+		if (display.lcd->LCDBufferDirtyGet() == false) {continue;}
+		if (budgetBytes - bytesSent < _LCDManagerMinBytes) {break;}
+
+		bytesSent += display.lcd->LCDFlush(budgetBytes - bytesSent);
+		if (display.lcd->LCDBufferDirtyGet() == false)
+		{
+			display.frames++;
+			_frames++;
+		}
+	}
+	// next frame starts with the first display not served, else move on by one
+	if (_count > 0) {
+		_next = (served < _count) ? (_next + served) % _count : (_next + 1) % _count;
+	}
+
+	uint64_t now = time_us_64();
+	if (now - _windowStart >= _LCDManagerFPSWindow)
+	{
+		_fps = (uint16_t)(((uint64_t)(_frames - _windowFrames) * 1000000) / (now - _windowStart));
+		_windowFrames = _frames;
+		_windowStart = now;
+	}
+	return bytesSent;
+}
+
+/*!
+	@brief Number of display frames sent, all displays
+	@return frame count
+*/
+uint32_t HD44780LCDManager::LCDManagerFramesGet(void){return _frames;}
+
+/*!
+	@brief Number of frames sent to one display
+	@param index display index returned by LCDManagerAdd
+	@return frame count , 0 if index is out of range
+*/
+uint32_t HD44780LCDManager::LCDManagerFramesGet(uint8_t index)
+{
+	return (index < _count) ? _displays[index].frames : 0;
+}
+
+/*!
+	@brief Aggregate display frames per second, all displays
+	@return frames per second, updated about once a second by LCDManagerFrame
+*/
+uint16_t HD44780LCDManager::LCDManagerFPSGet(void){return _fps;}
+
+// **** EOF ****
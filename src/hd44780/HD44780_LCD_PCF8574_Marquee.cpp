@@ -0,0 +1,166 @@
+/*!
+	@file     HD44780_LCD_PCF8574_Marquee.cpp
+	@author   Gavin Lyons
+	@brief    Marquee for HD44780 LCD, display shift or changed cell window scrolling.
+*/
+
+// Section : Includes
+#include <string.h>
+#include "../../include/hd44780/HD44780_LCD_PCF8574_Marquee.hpp"
+
+/*!
+	@brief Constructor for class HD44780LCDMarquee
+	@param lcd The LCD to scroll text on, LCDInit must be called before LCDMarqueeBegin
+*/
+HD44780LCDMarquee::HD44780LCDMarquee(HD44780LCD &lcd) : _lcd(lcd)
+{
+}
+
+// Section : Methods
+
+/*!
+	@brief Start scrolling a string and draw its first step
+	@param text Null terminated text, not copied
+	@param line Row 1-4
+	@param col First column of the region
+	@param width Columns in the region
+	@param stepUs Time between one column steps in uS
+	@param displayShift true = the whole display may move, allows the display shift method
+	@return false if the region does not fit on the LCD or stepUs is 0
+	@note Text no longer than the region is drawn and does not move.
+*/
+bool HD44780LCDMarquee::LCDMarqueeBegin(const char *text, HD44780LCD::LCDLineNumber_e line, uint8_t col,
+	uint8_t width, uint32_t stepUs, bool displayShift)
+{
+	uint8_t rows = _lcd.LCDNumRowsGet();
+	uint8_t cols = _lcd.LCDNumColsGet();
+
+	if (text == nullptr || stepUs == 0 || width == 0) {return false;}
+	if (line < 1 || line > rows || col + width > cols || width > _LCDMarqueeMaxWidth) {return false;}
+
+	_text = text;
+	_textLength = strlen(text);
+	_ringLength = _textLength + _LCDMarqueeGap;
+	_line = line;
+	_col = col;
+	_width = width;
+	_stepUs = stepUs;
+	_nextStepUs = 0;
+	_position = 0;
+	_windowValid = false;
+
+	// Display shift moves both DDRAM lines, which are rows 1 and 3 , 2 and 4 of a 4 row LCD
+	_displayShift = displayShift && rows <= 2 && col == 0 && width == cols
+		&& _ringLength <= _LCDMarqueeMaxWidth && _textLength > width
+		&& HD44780LCD::LCDCellAddress(rows, cols, line, cols - 1) ==
+			HD44780LCD::LCDCellAddress(rows, cols, line, 0) + cols - 1;
+	if (_displayShift == true)
+	{
+		// text padded to the 40 columns of the line, it repeats as the shift wraps
+		uint8_t ring[_LCDMarqueeMaxWidth];
+		_ringLength = _LCDMarqueeMaxWidth;
+		for (uint8_t i = 0; i < _LCDMarqueeMaxWidth; i++) {
+			ring[i] = LCDMarqueeRingChar(i);
+		}
+		_lcd.LCDHome(); // display shift back to 0
+		_lcd.LCDGOTO(line, 0);
+		_lcd.write(ring, _LCDMarqueeMaxWidth);
+		return true;
+	}
+	LCDMarqueeDraw();
+	return true;
+}
+
+/*!
+	@brief Stop scrolling, text is left on screen as it is
+	@note Call LCDHome to undo the display shift if it was used.
+*/
+void HD44780LCDMarquee::LCDMarqueeStop(void)
+{
+	_text = nullptr;
+}
+
+/*!
+	@brief Move the text if a step is due, never waits
+	@param nowUs Current time in uS, time_us_64() for example
+	@return true if the LCD was written
+	@details Steps missed by a late call are made up in one write. The first call starts the clock.
+*/
+bool HD44780LCDMarquee::LCDMarqueeTick(uint64_t nowUs)
+{
+	if (_text == nullptr || _textLength <= _width) {return false;}
+	if (_nextStepUs == 0)
+	{
+		_nextStepUs = nowUs + _stepUs;
+		return false;
+	}
+	if (nowUs < _nextStepUs) {return false;}
+
+	uint64_t steps = 1 + (nowUs - _nextStepUs) / _stepUs;
+	_nextStepUs += steps * _stepUs;
+	steps %= _ringLength;
+	if (steps == 0) {return false;}
+	_position = (_position + steps) % _ringLength;
+
+	if (_displayShift == true) {
+		_lcd.LCDScroll(_lcd.LCDMoveLeft, (uint8_t)steps);
+	} else {
+		LCDMarqueeDraw();
+	}
+	return true;
+}
+
+/*!
+	@brief Check which method LCDMarqueeBegin picked
+	@return true = display shift , false = window over the text
+*/
+bool HD44780LCDMarquee::LCDMarqueeDisplayShiftGet(void){return _displayShift;}
+
+/*!
+	@brief Write the cells of the region that differ from the last step
+	@details A run of changed cells is one address command and its characters,
+		see HD44780LCD::LCDChangedRunEnd.
+*/
+void HD44780LCDMarquee::LCDMarqueeDraw(void)
+{
+	uint8_t rows = _lcd.LCDNumRowsGet();
+	uint8_t cols = _lcd.LCDNumColsGet();
+	uint8_t window[_LCDMarqueeMaxWidth];
+	bool changed[_LCDMarqueeMaxWidth];
+	bool follows[_LCDMarqueeMaxWidth]; // DDRAM address is one on from the cell before
+
+	for (uint8_t cell = 0; cell < _width; cell++)
+	{
+		window[cell] = LCDMarqueeRingChar((_position + cell) % _ringLength);
+		changed[cell] = (_windowValid == false || window[cell] != _window[cell]);
+		follows[cell] = cell > 0 && HD44780LCD::LCDCellAddress(rows, cols, _line, _col + cell) ==
+			HD44780LCD::LCDCellAddress(rows, cols, _line, _col + cell - 1) + 1;
+	}
+
+	uint8_t cell = 0;
+	while (cell < _width)
+	{
+		if (changed[cell] == false) {
+			cell++;
+			continue;
+		}
+		uint8_t runEnd = HD44780LCD::LCDChangedRunEnd(changed, follows, cell, _width);
+		_lcd.LCDGOTO(_line, _col + cell);
+		_lcd.write(&window[cell], runEnd - cell);
+		cell = runEnd;
+	}
+	memcpy(_window, window, _width);
+	_windowValid = true;
+}
+
+/*!
+	@brief Character at a position of the text ring
+	@param index 0 to _ringLength - 1
+	@return text character or a space in the gap
+*/
+uint8_t HD44780LCDMarquee::LCDMarqueeRingChar(size_t index)
+{
+	return (index < _textLength) ? (uint8_t)_text[index] : ' ';
+}
+
+// **** EOF ****
@@ -40,6 +40,7 @@ size_t Print::write(const uint8_t *buffer, size_t size)
   return n;
 }
 
+#if HD44780_LCD_STD_STRING
 size_t Print::print(const std::string &s) {
     return write(s.c_str(), s.length());
 }
@@ -49,6 +50,17 @@ size_t Print::println(const std::string &s) {
     n += println();
     return n;
 }
+#endif
+
+size_t Print::print(std::string_view s) {
+    return write(s.data(), s.length());
+}
+
+size_t Print::println(std::string_view s) {
+    size_t n = print(s);
+    n += println();
+    return n;
+}
 
 size_t Print::print(const char str[])
 {
@@ -77,12 +89,11 @@ size_t Print::print(long n, int base)
   if (base == 0) {
     return write(n);
   } else if (base == 10) {
-    if (n < 0) {
-      int t = print('-');
-      n = -n;
-      return printNumber(n, 10) + t;
-    }
-    return printNumber(n, 10);
+    char buf[8 * sizeof(long) + 1];
+    char *end = &buf[sizeof(buf)];
+    char *str = formatNumber(end, n < 0 ? 0UL - (unsigned long)n : (unsigned long)n, 10);
+    if (n < 0) *--str = '-';
+    return write(str, end - str);
   } else {
     return printNumber(n, base);
   }
@@ -99,6 +110,21 @@ size_t Print::print(double n, int digits)
   return printFloat(n, digits);
 }
 
+// Print a fixed point number, value / 10^scale, e.g. printFixed(-1234, 2) prints -12.34
+// No floating point, scale 0-9
+size_t Print::printFixed(int32_t value, uint8_t scale)
+{
+  char buf[16];
+  char *end = &buf[sizeof(buf)];
+  uint32_t magnitude = value < 0 ? 0UL - (uint32_t)value : (uint32_t)value;
+
+  if (scale > 9) scale = 9;
+  char *str = formatFraction(end, magnitude % powersOfTen[scale], scale);
+  str = formatNumber(str, magnitude / powersOfTen[scale], 10);
+  if (value < 0) *--str = '-';
+  return write(str, end - str);
+}
+
 
 size_t Print::println(void)
 {
@@ -156,38 +182,120 @@ size_t Print::println(double num, int digits)
   return n;
 }
 
+size_t Print::printlnFixed(int32_t value, uint8_t scale)
+{
+  size_t n = printFixed(value, scale);
+  n += println();
+  return n;
+}
+
 
 // Private Methods 
 
-size_t Print::printNumber(unsigned long n, uint8_t base)
-{
-  char buf[8 * sizeof(long) + 1]; // Assumes 8-bit chars plus zero byte.
-  char *str = &buf[sizeof(buf) - 1];
+const uint32_t Print::powersOfTen[10] = {
+  1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
 
-  *str = '\0';
+// Render n backwards ending at end, returns pointer to first character.
+// Decimal is table driven two digits at a time, other bases use a shift when they can.
+char *Print::formatNumber(char *end, unsigned long n, uint8_t base)
+{
+  static const char digitPairs[201] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+  char *str = end;
 
   // prevent crash if called with base == 1
   if (base < 2) base = 10;
 
+  if (base == 10) {
+    while (n >= 100) {
+      const char *pair = &digitPairs[(n % 100) * 2];
+      n /= 100;
+      *--str = pair[1];
+      *--str = pair[0];
+    }
+    if (n >= 10) {
+      *--str = digitPairs[n * 2 + 1];
+      *--str = digitPairs[n * 2];
+    } else {
+      *--str = '0' + n;
+    }
+    return str;
+  }
+
+  if ((base & (base - 1)) == 0) {
+    uint8_t shift = __builtin_ctz(base);
+    do {
+      char c = n & (base - 1);
+      n >>= shift;
+      *--str = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (n);
+    return str;
+  }
+
   do {
     char c = n % base;
     n /= base;
-
     *--str = c < 10 ? c + '0' : c + 'A' - 10;
   } while(n);
+  return str;
+}
 
-  return write(str);
+// Render "." plus a fraction zero padded to digits characters, backwards ending at end.
+char *Print::formatFraction(char *end, uint32_t fraction, uint8_t digits)
+{
+  char *str = end;
+  if (digits == 0) return str;
+  while (digits--) {
+    *--str = '0' + fraction % 10;
+    fraction /= 10;
+  }
+  *--str = '.';
+  return str;
 }
 
+size_t Print::printNumber(unsigned long n, uint8_t base)
+{
+  char buf[8 * sizeof(long)]; // Assumes 8-bit chars.
+  char *end = &buf[sizeof(buf)];
+  char *str = formatNumber(end, n, base);
+  return write(str, end - str);
+}
+
+// Converts to fixed point with one multiply, then formats with integer maths only,
+// so the FPU-less RP2040 does not loop through soft-float routines digit by digit.
+// Whole number is sent in one write. Over 9 digits does not fit the fixed point,
+// those calls take the digit by digit soft-float path and print as before.
 size_t Print::printFloat(double number, uint8_t digits) 
 { 
-  size_t n = 0;
-  
   if (isnan(number)) return print("nan");
   if (isinf(number)) return print("inf");
   if (number > 4294967040.0) return print ("ovf");  // constant determined empirically
   if (number <-4294967040.0) return print ("ovf");  // constant determined empirically
-  
+  if (digits > 9) return printFloatDigits(number, digits);
+
+  char buf[24];
+  char *end = &buf[sizeof(buf)];
+  bool negative = number < 0.0;
+  if (negative) number = -number;
+
+  // Round correctly so that print(1.999, 2) prints as "2.00"
+  uint64_t fixed = (uint64_t)(number * powersOfTen[digits] + 0.5);
+  unsigned long int_part = (unsigned long)(fixed / powersOfTen[digits]);
+  uint32_t remainder = (uint32_t)(fixed % powersOfTen[digits]);
+
+  char *str = formatFraction(end, remainder, digits);
+  str = formatNumber(str, int_part, 10);
+  if (negative) *--str = '-';
+  return write(str, end - str);
+}
+
+// Soft-float rendering one digit at a time, for more digits than the fixed point holds.
+size_t Print::printFloatDigits(double number, uint8_t digits)
+{
+  size_t n = 0;
+
   // Handle negative numbers
   if (number < 0.0)
   {
@@ -206,11 +314,7 @@ size_t Print::printFloat(double number, uint8_t digits)
   unsigned long int_part = (unsigned long)number;
   double remainder = number - (double)int_part;
   n += print(int_part);
-
-  // Print the decimal point, but only if there are digits beyond
-  if (digits > 0) {
-    n += print('.'); 
-  }
+  n += print('.');
 
   // Extract digits from the remainder one at a time
   while (digits-- > 0)
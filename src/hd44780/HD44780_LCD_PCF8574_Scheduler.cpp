@@ -0,0 +1,186 @@
+/*!
+	@file     HD44780_LCD_PCF8574_Scheduler.cpp
+	@author   Gavin Lyons
+	@brief    Refresh scheduler for HD44780 LCD, latest value wins regions sent by priority within a byte budget.
+*/
+
+// Section : Includes
+#include <string.h>
+#include "../../include/hd44780/HD44780_LCD_PCF8574_Scheduler.hpp"
+
+/*!
+	@brief Constructor for class HD44780LCDScheduler
+	@param lcd The LCD the regions are on
+*/
+HD44780LCDScheduler::HD44780LCDScheduler(HD44780LCD &lcd) : _lcd(lcd)
+{
+}
+
+// Section : Methods
+
+/*!
+	@brief Add a region of the screen
+	@param line Row 1-4
+	@param col First column
+	@param width Columns in the region
+	@param minIntervalUs Least time between refreshes in uS, 0 = no limit
+	@param priority Higher is sent first
+	@return region index , -1 if full or region is not one run of cells on the LCD
+	@note The region starts blank and not dirty, call after LCDInit.
+*/
+int8_t HD44780LCDScheduler::LCDSchedulerAdd(HD44780LCD::LCDLineNumber_e line, uint8_t col, uint8_t width,
+	uint32_t minIntervalUs, uint8_t priority)
+{
+	if (_count >= LCDSchedulerMaxRegions) {return -1;}
+	if (width == 0 || width > _LCDSchedulerMaxWidth) {return -1;}
+	uint8_t rows = _lcd.LCDNumRowsGet();
+	uint8_t cols = _lcd.LCDNumColsGet();
+	if (line < 1 || line > rows || col + width > cols) {return -1;}
+	// one run of DDRAM, columns 7 and 8 of a 16x01 are not in sequence
+	if (HD44780LCD::LCDCellAddress(rows, cols, line, col + width - 1) !=
+		HD44780LCD::LCDCellAddress(rows, cols, line, col) + width - 1) {return -1;}
+
+	LCDSchedulerRegion_t &region = _regions[_count];
+	region.line = line;
+	region.col = col;
+	region.width = width;
+	region.priority = priority;
+	region.minIntervalUs = minIntervalUs;
+	region.lastRefreshUs = 0;
+	region.dirtySinceUs = 0;
+	region.dirty = false;
+	region.refreshed = false;
+	memset(region.pending, ' ', width);
+	memset(region.shown, ' ', width);
+	return _count++;
+}
+
+/*!
+	@brief Set the text of a region, sent by a later LCDSchedulerTick
+	@param region region index returned by LCDSchedulerAdd
+	@param text Null terminated text, cut or padded with spaces to the region width
+	@return false if region is out of range
+	@note Replaces any text written since the last refresh.
+*/
+bool HD44780LCDScheduler::LCDSchedulerWrite(uint8_t region, const char *text)
+{
+	if (region >= _count || text == nullptr) {return false;}
+	LCDSchedulerRegion_t &target = _regions[region];
+
+	uint8_t cell = 0;
+	for (; cell < target.width && text[cell] != '\0'; cell++) {
+		target.pending[cell] = text[cell];
+	}
+	memset(&target.pending[cell], ' ', target.width - cell);
+
+	bool dirty = memcmp(target.pending, target.shown, target.width) != 0;
+	if (dirty == true && target.dirty == false) {target.dirtySinceUs = _tickUs;}
+	target.dirty = dirty;
+	return true;
+}
+
+/*!
+	@brief Send dirty regions within a byte budget
+	@param nowUs Current time in uS, time_us_64() for example
+	@param budgetBytes Most bytes to write on the I2C bus this tick, 4 per character or command
+	@return Number of bytes written on the I2C bus
+	@details Regions still inside their minimum interval wait. Of the others the one with
+		the highest aged priority goes first, oldest change first on a tie.
+		Only the span from the first to the last changed cell is sent.
+*/
+uint16_t HD44780LCDScheduler::LCDSchedulerTick(uint64_t nowUs, uint16_t budgetBytes)
+{
+	uint16_t bytesSent = 0;
+	bool served[LCDSchedulerMaxRegions] = {};
+
+	_tickUs = nowUs;
+	while (budgetBytes - bytesSent >= _LCDSchedulerMinBytes)
+	{
+		int8_t best = -1;
+		uint16_t bestPriority = 0;
+		for (uint8_t index = 0; index < _count; index++)
+		{
+			LCDSchedulerRegion_t &region = _regions[index];
+			if (region.dirty == false || served[index] == true) {continue;}
+			if (region.refreshed == true && nowUs - region.lastRefreshUs < region.minIntervalUs) {continue;}
+
+			uint16_t priority = LCDSchedulerPriority(region, nowUs);
+			if (best < 0 || priority > bestPriority ||
+				(priority == bestPriority && region.dirtySinceUs < _regions[best].dirtySinceUs))
+			{
+				best = index;
+				bestPriority = priority;
+			}
+		}
+		if (best < 0) {break;}
+		served[best] = true;
+		bytesSent += LCDSchedulerSend(_regions[best], nowUs, budgetBytes - bytesSent);
+	}
+	return bytesSent;
+}
+
+/*!
+	@brief Check if a region has text not yet on screen
+	@param region region index returned by LCDSchedulerAdd
+	@return true if dirty , false if sent or out of range
+*/
+bool HD44780LCDScheduler::LCDSchedulerDirtyGet(uint8_t region)
+{
+	return (region < _count) ? _regions[region].dirty : false;
+}
+
+uint8_t HD44780LCDScheduler::LCDSchedulerCountGet(void){return _count;}
+
+/*!
+	@brief Priority of a region raised by the time it has waited
+	@param region The region
+	@param nowUs Current time in uS
+	@return aged priority
+*/
+uint16_t HD44780LCDScheduler::LCDSchedulerPriority(const LCDSchedulerRegion_t &region, uint64_t nowUs)
+{
+	uint64_t age = (nowUs > region.dirtySinceUs) ? (nowUs - region.dirtySinceUs) / _LCDSchedulerAgeUs : 0;
+	return region.priority + (uint16_t)((age > UINT8_MAX) ? UINT8_MAX : age);
+}
+
+/*!
+	@brief Send the changed span of a region, or as much of it as fits
+	@param region The region
+	@param nowUs Current time in uS
+	@param maxBytes Most bytes to write on the I2C bus
+	@return Number of bytes written on the I2C bus , the address command only if it was needed
+*/
+uint16_t HD44780LCDScheduler::LCDSchedulerSend(LCDSchedulerRegion_t &region, uint64_t nowUs, uint16_t maxBytes)
+{
+	const uint8_t I2CBytesPerByte = 4; // two nibbles , each with enable high and low
+	uint8_t first = 0;
+	uint8_t last = region.width - 1;
+
+	while (first < region.width && region.pending[first] == region.shown[first]) {first++;}
+	while (last > first && region.pending[last] == region.shown[last]) {last--;}
+	if (first == region.width)
+	{
+		region.dirty = false;
+		return 0;
+	}
+
+	uint8_t length = last - first + 1;
+	uint8_t fits = maxBytes / I2CBytesPerByte - 1; // one command for the address
+	if (length > fits) {length = fits;}
+
+	bool addressSent = _lcd.LCDGOTOAddress(HD44780LCD::LCDCellAddress(_lcd.LCDNumRowsGet(), _lcd.LCDNumColsGet(),
+		region.line, region.col + first));
+	_lcd.write(&region.pending[first], length);
+	memcpy(&region.shown[first], &region.pending[first], length);
+
+	// a region cut short stays dirty and keeps its place in the queue
+	if (first + length > last)
+	{
+		region.dirty = false;
+		region.refreshed = true;
+		region.lastRefreshUs = nowUs;
+	}
+	return I2CBytesPerByte * ((addressSent ? 1 : 0) + length);
+}
+
+// **** EOF ****
@@ -0,0 +1,253 @@
+/*!
+	@file     HD44780_LCD_PCF8574_Service.cpp
+	@author   Gavin Lyons
+	@brief    Display service for HD44780 LCD, lock-free single-producer/single-consumer command ring.
+*/
+
+// Section : Includes
+#include <string.h>
+#include "pico/stdlib.h"
+#include "../../include/hd44780/HD44780_LCD_PCF8574_Service.hpp"
+
+/*!
+	@brief Constructor for class HD44780LCDService
+	@param lcd The LCD, must be initialised before LCDServiceRun is started
+	@param overflow What to do when the ring is full, see LCDServiceOverflow_e
+*/
+HD44780LCDService::HD44780LCDService(HD44780LCD &lcd, LCDServiceOverflow_e overflow) :
+	_lcd(lcd), _overflow(overflow)
+{
+}
+
+// Section : Producer
+
+/*!
+	@brief Queue a cursor move
+	@param line row 1-4
+	@param col column 0-15 or 0-19
+	@return true if queued, false if dropped
+*/
+bool HD44780LCDService::LCDServiceGOTO(HD44780LCD::LCDLineNumber_e line, uint8_t col)
+{
+	LCDServiceCommand_t command{};
+	command.type = LCDServiceCmdGOTO;
+	command.arg1 = line;
+	command.arg2 = col;
+	return LCDServicePush(command);
+}
+
+/*!
+	@brief Queue a string, split into commands of up to 20 characters
+	@param str Pointer to the char array, copied into the ring
+	@return true if all of it was queued, false if any part was dropped
+*/
+bool HD44780LCDService::LCDServiceText(const char *str)
+{
+	bool queued = true;
+	size_t length = strlen(str);
+	do {
+		LCDServiceCommand_t command{};
+		command.type = LCDServiceCmdText;
+		command.length = (length > _LCDServiceTextMax) ? _LCDServiceTextMax : length;
+		memcpy(command.data, str, command.length);
+		queued &= LCDServicePush(command);
+		str += command.length;
+		length -= command.length;
+	} while (length > 0);
+	return queued;
+}
+
+/*!
+	@brief Queue a custom character upload to CGRAM
+	@param location CGRAM location 0-7
+	@param charmap An array of 8 bytes, copied into the ring
+	@return true if queued, false if dropped
+*/
+bool HD44780LCDService::LCDServiceCreateCustomChar(uint8_t location, const uint8_t *charmap)
+{
+	LCDServiceCommand_t command{};
+	command.type = LCDServiceCmdCreateChar;
+	command.arg1 = location;
+	command.length = 8;
+	memcpy(command.data, charmap, 8);
+	return LCDServicePush(command);
+}
+
+/*!
+	@brief Queue printing a custom character
+	@param location CGRAM location 0-7
+	@return true if queued, false if dropped
+*/
+bool HD44780LCDService::LCDServicePrintCustomChar(uint8_t location)
+{
+	LCDServiceCommand_t command{};
+	command.type = LCDServiceCmdPrintChar;
+	command.arg1 = location;
+	return LCDServicePush(command);
+}
+
+/*!
+	@brief Queue a backlight change
+	@param OnOff true = LED on , false = LED off
+	@return true if queued, false if dropped
+*/
+bool HD44780LCDService::LCDServiceBackLight(bool OnOff)
+{
+	LCDServiceCommand_t command{};
+	command.type = LCDServiceCmdBackLight;
+	command.arg1 = OnOff;
+	return LCDServicePush(command);
+}
+
+/*!
+	@brief Queue a clear screen
+	@return true if queued, false if dropped
+*/
+bool HD44780LCDService::LCDServiceClear(void)
+{
+	LCDServiceCommand_t command{};
+	command.type = LCDServiceCmdClear;
+	return LCDServicePush(command);
+}
+
+/*!
+	@brief Number of commands lost to ring overflow
+	@return Rejected commands (drop newest) plus overwritten commands (drop oldest)
+*/
+uint32_t HD44780LCDService::LCDServiceDroppedGet(void)
+{
+	return _producerDrops.load(std::memory_order_relaxed) + _consumerDrops.load(std::memory_order_relaxed);
+}
+
+/*!
+	@brief Publish a command into the ring, wait-free
+	@param command The command to copy in
+	@return true if queued , false if dropped
+	@details Slot is written seqlock style, odd sequence while writing, so the consumer
+		can detect a slot the producer is overwriting. Only loads and stores are used,
+		the RP2040 M0+ cores have no atomic read-modify-write.
+*/
+bool HD44780LCDService::LCDServicePush(const LCDServiceCommand_t &command)
+{
+	uint32_t head = _head.load(std::memory_order_relaxed);
+
+	if (_overflow == LCDServiceDropNewest &&
+		head - _tail.load(std::memory_order_acquire) >= _LCDServiceRingSize)
+	{
+		_producerDrops.store(_producerDrops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		return false;
+	}
+
+	uint32_t words[_LCDServiceWords];
+	memcpy(words, &command, sizeof(words));
+
+	LCDServiceSlot_t &slot = _ring[head & (_LCDServiceRingSize - 1)];
+	slot.seq.store(2 * head + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (uint8_t i = 0; i < _LCDServiceWords; i++) {
+		slot.words[i].store(words[i], std::memory_order_relaxed);
+	}
+	slot.seq.store(2 * head + 2, std::memory_order_release);
+	_head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+// Section : Consumer
+
+/*!
+	@brief Take one command from the ring and perform it on the LCD
+	@return true if a command was performed , false if the ring was empty
+	@note If the LCD is in buffered mode the frame buffer is flushed each time the ring runs empty,
+		so repeated writes to the same position cost nothing on the bus.
+*/
+bool HD44780LCDService::LCDServiceProcess(void)
+{
+	uint32_t tail = _tail.load(std::memory_order_relaxed);
+
+	while (true)
+	{
+		uint32_t head = _head.load(std::memory_order_acquire);
+		if (tail == head)
+		{
+			_tail.store(tail, std::memory_order_release);
+			_lcd.LCDFlush();
+			return false;
+		}
+		// Producer lapped us, skip to the oldest command still in the ring
+		if (head - tail > _LCDServiceRingSize)
+		{
+			_consumerDrops.store(_consumerDrops.load(std::memory_order_relaxed) + (head - tail - _LCDServiceRingSize), std::memory_order_relaxed);
+			tail = head - _LCDServiceRingSize;
+		}
+
+		LCDServiceSlot_t &slot = _ring[tail & (_LCDServiceRingSize - 1)];
+		uint32_t seqBefore = slot.seq.load(std::memory_order_acquire);
+		uint32_t words[_LCDServiceWords];
+		for (uint8_t i = 0; i < _LCDServiceWords; i++) {
+			words[i] = slot.words[i].load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint32_t seqAfter = slot.seq.load(std::memory_order_relaxed);
+		tail++;
+
+		if (seqBefore != 2 * tail || seqAfter != seqBefore)
+		{
+			// Overwritten while we were reading it, it is lost
+			_consumerDrops.store(_consumerDrops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			continue;
+		}
+		_tail.store(tail, std::memory_order_release);
+
+		LCDServiceCommand_t command;
+		memcpy(&command, words, sizeof(command));
+		LCDServiceExecute(command);
+		return true;
+	}
+}
+
+/*!
+	@brief Service loop for core1, never returns
+	@note Launch with multicore_launch_core1 from a function that calls this.
+*/
+void HD44780LCDService::LCDServiceRun(void)
+{
+	while (true)
+	{
+		if (LCDServiceProcess() == false) {
+			tight_loop_contents();
+		}
+	}
+}
+
+/*!
+	@brief Perform one command on the LCD
+	@param command The command
+*/
+void HD44780LCDService::LCDServiceExecute(const LCDServiceCommand_t &command)
+{
+	uint8_t charmap[8];
+	switch (command.type)
+	{
+		case LCDServiceCmdGOTO:
+			_lcd.LCDGOTO((HD44780LCD::LCDLineNumber_e)command.arg1, command.arg2);
+		break;
+		case LCDServiceCmdText:
+			_lcd.write(command.data, command.length);
+		break;
+		case LCDServiceCmdCreateChar:
+			memcpy(charmap, command.data, 8);
+			_lcd.LCDCreateCustomChar(command.arg1, charmap);
+		break;
+		case LCDServiceCmdPrintChar:
+			_lcd.LCDPrintCustomChar(command.arg1);
+		break;
+		case LCDServiceCmdBackLight:
+			_lcd.LCDBackLightSet(command.arg1);
+		break;
+		case LCDServiceCmdClear:
+			_lcd.LCDClearScreenCmd();
+		break;
+	}
+}
+
+// **** EOF ****
@@ -0,0 +1,237 @@
+/*!
+	@file     HD44780_Emulator.cpp
+	@author   Gavin Lyons
+	@brief    Host model of a PCF8574 backpack and HD44780 controller, fed the port bytes written on the bus.
+*/
+
+// Section : Includes
+#include <stdio.h>
+#include <string.h>
+#include "HD44780_Emulator.hpp"
+
+/*!
+	@brief Constructor for class HD44780Emulator
+	@param address 7 bit I2C address of the PCF8574
+*/
+HD44780Emulator::HD44780Emulator(uint8_t address) : address(address)
+{
+	EmuPowerOn(0);
+}
+
+/*!
+	@brief Put the controller in its power on state
+	@param nowNs Time of power on, the controller is busy for 15mS
+*/
+void HD44780Emulator::EmuPowerOn(uint64_t nowNs)
+{
+	memset(ddram, ' ', sizeof(ddram));
+	memset(cgram, 0, sizeof(cgram));
+	port = 0xFF;
+	addressCounter = 0;
+	cgramSelected = false;
+	eightBit = true;
+	increment = true;
+	shiftOnWrite = false;
+	displayShift = 0;
+	displayControl = 0x08;
+	functionSet = 0x30;
+	commands = characters = busyWrites = reads = 0;
+	_busyUntilNs = nowNs + 15000000;
+	_secondNibble = false;
+	_readLower = false;
+}
+
+/*!
+	@brief Write the PCF8574 port
+	@param portByte D7-D4 | LED | EN | RW | RS
+	@param nowNs Time the byte is latched by the PCF8574
+*/
+void HD44780Emulator::EmuPortWrite(uint8_t portByte, uint64_t nowNs)
+{
+	bool fallingEdge = (port & 0x04) && !(portByte & 0x04);
+	port = portByte;
+	if (fallingEdge == false) {return;}
+
+	if (portByte & 0x02) // read, enable pulse moves on to the next nibble
+	{
+		if (eightBit == false) {_readLower = !_readLower;}
+		return;
+	}
+	_readLower = false;
+	if (EmuBusy(nowNs)) {busyWrites++;}
+
+	uint8_t nibble = portByte & 0xF0;
+	bool isData = portByte & 0x01;
+	if (eightBit == true)
+	{
+		_secondNibble = false;
+		EmuExecute(nibble, isData, nowNs); // D3-D0 are not wired, read as 0
+	} else if (_secondNibble == false) {
+		_upperNibble = nibble;
+		_upperRS = isData;
+		_secondNibble = true;
+	} else {
+		_secondNibble = false;
+		EmuExecute(_upperNibble | (nibble >> 4), _upperRS, nowNs);
+	}
+}
+
+/*!
+	@brief Read the PCF8574 port
+	@param nowNs Time of the read
+	@return Port pins, D7-D4 are driven by the controller while RW and EN are high
+*/
+uint8_t HD44780Emulator::EmuPortRead(uint64_t nowNs)
+{
+	if ((port & 0x06) != 0x06) {return port;}
+	reads++;
+	uint8_t value = (EmuBusy(nowNs) ? 0x80 : 0x00) | (addressCounter & 0x7F);
+	uint8_t nibble = (eightBit == false && _readLower == true) ? (uint8_t)(value << 4) : (value & 0xF0);
+	return (port & 0x0F) | (nibble & 0xF0);
+}
+
+/*!
+	@brief Check the busy flag
+	@param nowNs Time to check at
+	@return true while a command is running
+*/
+bool HD44780Emulator::EmuBusy(uint64_t nowNs) const {return nowNs < _busyUntilNs;}
+
+/*!
+	@brief Carry out an instruction or data write
+	@param value Instruction or data byte
+	@param isData RS
+	@param nowNs Time the write completes
+*/
+void HD44780Emulator::EmuExecute(uint8_t value, bool isData, uint64_t nowNs)
+{
+	uint32_t runNs = EmuCommandNs;
+
+	if (isData == true)
+	{
+		characters++;
+		runNs = EmuDataNs;
+		if (cgramSelected == true) {
+			cgram[addressCounter & 0x3F] = value;
+		} else {
+			ddram[addressCounter & 0x7F] = value;
+		}
+		EmuAddressStep(increment);
+		if (shiftOnWrite == true && cgramSelected == false) {
+			displayShift = (displayShift + (increment ? 1 : 39)) % 40;
+		}
+		_busyUntilNs = nowNs + runNs;
+		return;
+	}
+
+	commands++;
+	if (value & 0x80) {
+		addressCounter = value & 0x7F;
+		cgramSelected = false;
+	} else if (value & 0x40) {
+		addressCounter = value & 0x3F;
+		cgramSelected = true;
+	} else if (value & 0x20) {
+		functionSet = value;
+		eightBit = value & 0x10;
+	} else if (value & 0x10) {
+		bool right = value & 0x04;
+		if (value & 0x08) {
+			displayShift = (displayShift + (right ? 39 : 1)) % 40;
+		} else {
+			EmuAddressStep(right);
+		}
+	} else if (value & 0x08) {
+		displayControl = value;
+	} else if (value & 0x04) {
+		increment = value & 0x02;
+		shiftOnWrite = value & 0x01;
+	} else if (value & 0x02) {
+		addressCounter = 0;
+		cgramSelected = false;
+		displayShift = 0;
+		runNs = EmuClearNs;
+	} else if (value & 0x01) {
+		memset(ddram, ' ', sizeof(ddram));
+		addressCounter = 0;
+		cgramSelected = false;
+		displayShift = 0;
+		increment = true;
+		runNs = EmuClearNs;
+	}
+	_busyUntilNs = nowNs + runNs;
+}
+
+/*!
+	@brief Move the address counter one place
+	@param forward true = increment
+*/
+void HD44780Emulator::EmuAddressStep(bool forward)
+{
+	if (cgramSelected == true)
+	{
+		addressCounter = (addressCounter + (forward ? 1 : 63)) & 0x3F;
+		return;
+	}
+	uint8_t line = addressCounter & 0x40;
+	uint8_t offset = addressCounter & 0x3F;
+	if (forward == true) {
+		if (++offset >= 40) {offset = 0; line ^= 0x40;}
+	} else {
+		if (offset-- == 0) {offset = 39; line ^= 0x40;}
+	}
+	addressCounter = line | offset;
+}
+
+/*!
+	@brief Get the text shown on one row, with the display shift applied
+	@param line row 1-4
+	@param rows rows on the LCD
+	@param cols columns on the LCD
+	@return cols characters, codes below 0x20 are shown as '#'
+*/
+std::string HD44780Emulator::EmuRowText(uint8_t line, uint8_t rows, uint8_t cols) const
+{
+	std::string text;
+	for (uint8_t col = 0; col < cols; col++)
+	{
+		// same cell layout as HD44780LCD::LCDCellAddress
+		uint8_t lineBase = (line == 2 || line == 4) ? 0x40 : 0x00;
+		uint8_t offset = ((line >= 3) ? cols : 0) + col;
+		if (rows == 1 && cols == 16 && col >= 8) {lineBase = 0x40; offset = col - 8;}
+		uint8_t character = ddram[lineBase + (offset + displayShift) % 40];
+		text += (character < 0x20) ? '#' : (char)character;
+	}
+	return text;
+}
+
+/*!
+	@brief Get the text of the whole screen
+	@param rows rows on the LCD
+	@param cols columns on the LCD
+	@return rows joined with a new line
+*/
+std::string HD44780Emulator::EmuScreenText(uint8_t rows, uint8_t cols) const
+{
+	std::string text;
+	for (uint8_t line = 1; line <= rows; line++)
+	{
+		if (line > 1) {text += '\n';}
+		text += EmuRowText(line, rows, cols);
+	}
+	return text;
+}
+
+/*!
+	@brief Print the screen in a box
+	@param rows rows on the LCD
+	@param cols columns on the LCD
+*/
+void HD44780Emulator::EmuPrint(uint8_t rows, uint8_t cols) const
+{
+	for (uint8_t line = 1; line <= rows; line++) {
+		printf("|%s|\n", EmuRowText(line, rows, cols).c_str());
+	}
+}
+
+// **** EOF ****
@@ -0,0 +1,69 @@
+/*!
+	@file     HD44780_Emulator.hpp
+	@author   Gavin Lyons
+	@brief    Host model of a PCF8574 backpack and HD44780 controller, fed the port bytes written on the bus.
+*/
+
+#ifndef LCD_HD44780_EMULATOR_H
+#define LCD_HD44780_EMULATOR_H
+
+#include <stdint.h>
+#include <string>
+
+/*!
+	@brief PCF8574 port expander wired to an HD44780 controller, as on the common backpacks
+	@details Port bits D7-D4 | LED | EN | RW | RS. The controller latches on the falling edge
+		of EN, a nibble at a time in 4 bit mode. It starts in 8 bit mode as after power on.
+		DDRAM is two lines of 40, the address counter wraps 0x27 to 0x40 and 0x67 to 0x00.
+		Each command keeps the controller busy for its datasheet time, a write that arrives
+		while busy is counted in busyWrites and is still carried out.
+*/
+class HD44780Emulator {
+	public:
+		HD44780Emulator(uint8_t address = 0x27);
+
+		void EmuPowerOn(uint64_t nowNs);
+		void EmuPortWrite(uint8_t portByte, uint64_t nowNs);
+		uint8_t EmuPortRead(uint64_t nowNs);
+
+		std::string EmuRowText(uint8_t line, uint8_t rows, uint8_t cols) const;
+		std::string EmuScreenText(uint8_t rows, uint8_t cols) const;
+		void EmuPrint(uint8_t rows, uint8_t cols) const;
+		bool EmuBusy(uint64_t nowNs) const;
+
+		static constexpr uint32_t EmuCommandNs = 37000; /**< Most commands */
+		static constexpr uint32_t EmuDataNs = 41000; /**< DDRAM or CGRAM write */
+		static constexpr uint32_t EmuClearNs = 1520000; /**< Clear display and return home */
+
+		uint8_t address; /**< 7 bit I2C address */
+		bool present = true; /**< false = address is not acknowledged */
+
+		uint8_t port = 0xFF; /**< Last byte written to the PCF8574 */
+		uint8_t ddram[128]; /**< Indexed by DDRAM address */
+		uint8_t cgram[64];
+		uint8_t addressCounter = 0;
+		bool cgramSelected = false; /**< Address counter points at CGRAM */
+		bool eightBit = true; /**< Interface width, set by function set */
+		bool increment = true; /**< Entry mode I/D */
+		bool shiftOnWrite = false; /**< Entry mode S */
+		uint8_t displayShift = 0; /**< Display shift left, 0-39 */
+		uint8_t displayControl = 0x08; /**< Last display control command */
+		uint8_t functionSet = 0x30; /**< Last function set command */
+
+		uint32_t commands = 0; /**< Commands carried out */
+		uint32_t characters = 0; /**< DDRAM and CGRAM writes carried out */
+		uint32_t busyWrites = 0; /**< Writes that arrived while the controller was busy */
+		uint32_t reads = 0; /**< Busy flag and address reads */
+
+	private:
+		void EmuExecute(uint8_t value, bool isData, uint64_t nowNs);
+		void EmuAddressStep(bool forward);
+
+		uint64_t _busyUntilNs = 0;
+		bool _secondNibble = false; /**< 4 bit mode, upper nibble has been latched */
+		uint8_t _upperNibble = 0;
+		bool _upperRS = false;
+		bool _readLower = false; /**< 4 bit read, next enable pulse reads the lower nibble */
+};
+
+#endif // guard header ending
@@ -0,0 +1,755 @@
+/*!
+	@file     HD44780_HostBus.cpp
+	@author   Gavin Lyons
+	@brief    Simulated Pico SDK I2C, DMA, interrupt and time layer for host builds of the HD44780 library.
+*/
+
+// Section : Includes
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/clocks.h"
+#include "HD44780_HostBus.hpp"
+#include "HD44780_HostPIO.hpp"
+
+HD44780HostBus hostBus;
+
+// Section : Simulation state
+
+namespace {
+
+constexpr size_t FIFODepth = 16;
+constexpr uint32_t IRQCount = 32;
+constexpr uint32_t IRQStormLimit = 64; // handler calls in a row that do not clear the cause
+constexpr uint64_t PollNs = 1000; // a status read or time check , so polling loops see time pass
+
+/*! One I2C block, registers and the transaction on the bus */
+struct HostI2CBlock {
+	struct Word {
+		uint32_t value;
+		uint64_t queuedNs;
+	};
+	i2c_hw_t *hw;
+	uint irq;
+	uint32_t baud = 100000;
+	bool enabled = false;
+	uint32_t tar = 0;
+	uint32_t intrMask = 0;
+	uint32_t txTl = 0;
+	bool abort = false;
+	bool addressed = false; // START and address byte sent, waiting on more data or STOP
+	uint64_t busFreeNs = 0; // end of the last bit on the bus
+	std::deque<Word> fifo;
+};
+
+/*! One DMA channel */
+struct HostDMAChannel {
+	bool claimed = false;
+	uint32_t remaining = 0;
+	const volatile uint8_t *read = nullptr;
+	volatile void *write = nullptr;
+	dma_channel_config config{};
+};
+
+std::recursive_mutex busLock;
+uint64_t clockNs = 0;
+HostBusCounters_t counters;
+i2c_hw_t hw0Registers, hw1Registers;
+HostI2CBlock blocks[2];
+HostDMAChannel dmaChannels[NUM_DMA_CHANNELS];
+irq_handler_t irqHandlers[IRQCount];
+bool irqEnabled[IRQCount];
+std::thread::id irqCore[IRQCount];
+thread_local bool interruptsOff = false;
+thread_local bool inInterrupt = false;
+
+/*! Half an SCL period */
+uint64_t HalfBitNs(const HostI2CBlock &block) {return 500000000ull / block.baud;}
+
+HostI2CBlock &BlockOf(i2c_inst_t *i2c) {return blocks[i2c_hw_index(i2c)];}
+
+/*! Is the address acknowledged, an injected NACK is used up */
+bool Acknowledge(uint8_t address)
+{
+	if (hostBus.faultNacks > 0)
+	{
+		hostBus.faultNacks--;
+		return false;
+	}
+	auto device = hostBus.devices.find(address);
+	return device != hostBus.devices.end() && device->second.present;
+}
+
+/*! Time the word at the head of the FIFO leaves the bus */
+uint64_t WordDoneNs(const HostI2CBlock &block)
+{
+	const HostI2CBlock::Word &word = block.fifo.front();
+	uint64_t halfBit = HalfBitNs(block);
+	uint64_t doneNs = std::max(block.busFreeNs, word.queuedNs) + 18 * halfBit;
+	if (block.addressed == false) {doneNs += 19 * halfBit;} // START and address byte
+	if (word.value & I2C_IC_DATA_CMD_STOP_BITS) {doneNs += halfBit;}
+	return doneNs;
+}
+
+/*! Clock the word at the head of the FIFO onto the bus */
+void WordSend(HostI2CBlock &block, uint64_t doneNs)
+{
+	HostI2CBlock::Word word = block.fifo.front();
+	uint64_t halfBit = HalfBitNs(block);
+	uint64_t startNs = std::max(block.busFreeNs, word.queuedNs);
+	block.fifo.pop_front();
+	counters.busTimeNs += doneNs - startNs;
+	block.busFreeNs = doneNs;
+
+	bool acked = true;
+	if (block.addressed == false)
+	{
+		acked = Acknowledge(block.tar & 0x7F);
+		block.addressed = true;
+	}
+	if (acked == true && hostBus.faultAbortWord >= 0 && counters.fifoWords == (uint32_t)hostBus.faultAbortWord) {
+		acked = false;
+	}
+	counters.fifoWords++;
+	if (acked == false) // abort flushes the FIFO and sends STOP
+	{
+		counters.nacks++;
+		counters.transactions++;
+		block.abort = true;
+		block.addressed = false;
+		block.fifo.clear();
+		return;
+	}
+	uint64_t byteNs = doneNs - ((word.value & I2C_IC_DATA_CMD_STOP_BITS) ? halfBit : 0);
+	hostBus.devices[block.tar & 0x7F].EmuPortWrite((uint8_t)word.value, byteNs);
+	counters.bytes++;
+	if (word.value & I2C_IC_DATA_CMD_STOP_BITS)
+	{
+		counters.transactions++;
+		block.addressed = false;
+	}
+}
+
+/*! Move words from DMA channels into the I2C or PIO TX FIFO that paces them while there is room */
+void DMAPump(void)
+{
+	for (HostDMAChannel &channel : dmaChannels)
+	{
+		uint32_t size = 1u << channel.config.size;
+		while (channel.remaining > 0)
+		{
+			uint32_t word = 0;
+			memcpy(&word, (const void *)channel.read, size);
+			if (channel.config.dreq >= 32)
+			{
+				if (channel.config.dreq > 34 || (channel.config.dreq & 1)) {break;} // only I2C TX
+				HostI2CBlock &block = blocks[(channel.config.dreq - 32) / 2];
+				if (block.fifo.size() >= FIFODepth) {break;}
+				block.hw->data_cmd = word;
+			} else if (HostPIODMAWrite(channel.config.dreq, word) == false) {
+				break;
+			}
+			if (channel.config.readIncrement == true) {channel.read += size;}
+			channel.remaining--;
+		}
+	}
+}
+
+uint32_t RawInterrupts(const HostI2CBlock &block)
+{
+	uint32_t raw = 0;
+	if (block.fifo.size() <= block.txTl) {raw |= I2C_IC_RAW_INTR_STAT_TX_EMPTY_BITS;}
+	if (block.abort == true) {raw |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;}
+	return raw;
+}
+
+/*! Call the handler of each raised and enabled interrupt owned by this thread */
+void InterruptsDispatch(void)
+{
+	if (interruptsOff == true || inInterrupt == true) {return;}
+	for (HostI2CBlock &block : blocks)
+	{
+		for (uint32_t calls = 0; calls < IRQStormLimit; calls++)
+		{
+			if (irqEnabled[block.irq] == false || irqHandlers[block.irq] == nullptr ||
+				irqCore[block.irq] != std::this_thread::get_id()) {break;}
+			if ((RawInterrupts(block) & block.intrMask) == 0) {break;}
+			inInterrupt = true;
+			counters.interrupts++;
+			irqHandlers[block.irq]();
+			inInterrupt = false;
+		}
+	}
+}
+
+/*! Move the clock on, running the bus up to the new time */
+void AdvanceTo(uint64_t untilNs)
+{
+	while (true)
+	{
+		HostI2CBlock *next = nullptr;
+		uint64_t nextNs = untilNs;
+		for (HostI2CBlock &block : blocks)
+		{
+			if (block.fifo.empty() || block.enabled == false) {continue;}
+			uint64_t doneNs = WordDoneNs(block);
+			if (doneNs <= nextNs) {next = &block; nextNs = doneNs;}
+		}
+		if (next == nullptr) {break;}
+		clockNs = std::max(clockNs, nextNs);
+		WordSend(*next, nextNs);
+		DMAPump();
+		InterruptsDispatch();
+	}
+	clockNs = std::max(clockNs, untilNs);
+	HostPIORun(clockNs);
+	InterruptsDispatch();
+}
+
+/*! Wait for the FIFO of a block to drain and the bus to go idle */
+void DrainBlock(HostI2CBlock &block)
+{
+	while (block.fifo.empty() == false && block.enabled == true) {AdvanceTo(WordDoneNs(block));}
+	AdvanceTo(std::max(clockNs, block.busFreeNs));
+}
+
+/*! A blocking write or read, address phase */
+bool AddressPhase(HostI2CBlock &block, uint8_t address, uint64_t &nowNs)
+{
+	DrainBlock(block);
+	nowNs = clockNs;
+	counters.transactions++;
+	nowNs += 19 * HalfBitNs(block);
+	if (Acknowledge(address) == false)
+	{
+		nowNs += HalfBitNs(block);
+		counters.nacks++;
+		counters.busTimeNs += nowNs - clockNs;
+		AdvanceTo(nowNs);
+		block.busFreeNs = clockNs;
+		return false;
+	}
+	return true;
+}
+
+/*! A blocking write or read, STOP and clock moved to the end */
+void StopPhase(HostI2CBlock &block, uint64_t nowNs)
+{
+	nowNs += HalfBitNs(block);
+	counters.busTimeNs += nowNs - clockNs;
+	AdvanceTo(nowNs);
+	block.busFreeNs = clockNs;
+}
+
+uint64_t UsToNs(uint64_t us) {return us * 1000;}
+
+} // namespace
+
+// Section : PIO simulator hooks
+
+std::recursive_mutex &HostBusLock(void) {return busLock;}
+HostBusCounters_t &HostBusCounters(void) {return counters;}
+void HostDMAPump(void) {DMAPump();}
+
+// Section : HD44780HostBus
+
+/*!
+	@brief Get a device on the bus, it is added and powered on if not there
+	@param address 7 bit I2C address
+	@return The device
+*/
+HD44780Emulator &HD44780HostBus::BusDevice(uint8_t address)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	auto device = devices.find(address);
+	if (device == devices.end())
+	{
+		device = devices.emplace(address, HD44780Emulator(address)).first;
+		device->second.EmuPowerOn(clockNs);
+	}
+	return device->second;
+}
+
+/*!
+	@brief Take a device off the bus, its address is no longer acknowledged
+	@param address 7 bit I2C address
+*/
+void HD44780HostBus::BusDeviceRemove(uint8_t address)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	devices.erase(address);
+}
+
+/*!
+	@brief Start again, clock at 0, one powered on device at 0x27 , no faults
+	@note Make LCD objects after the reset, their deadlines use the old clock.
+*/
+void HD44780HostBus::BusReset(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	clockNs = 0;
+	counters = HostBusCounters_t{};
+	for (HostI2CBlock &block : blocks)
+	{
+		i2c_hw_t *hw = block.hw;
+		uint irq = block.irq;
+		block = HostI2CBlock{};
+		block.hw = hw;
+		block.irq = irq;
+	}
+	for (HostDMAChannel &channel : dmaChannels) {channel = HostDMAChannel{};}
+	for (uint32_t irq = 0; irq < IRQCount; irq++)
+	{
+		irqHandlers[irq] = nullptr;
+		irqEnabled[irq] = false;
+	}
+	faultNacks = 0;
+	faultTimeoutAfter = -1;
+	faultSDAStuck = 0;
+	faultAbortWord = -1;
+	faultMaxKHz = 0;
+	HostPIOReset();
+	devices.clear();
+	BusDevice(0x27);
+}
+
+/*! @brief Get the simulated time in nS */
+uint64_t HD44780HostBus::BusNowNs(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	return clockNs;
+}
+
+/*!
+	@brief Move the simulated clock on, the FIFOs drain and interrupts run meanwhile
+	@param us Time in uS
+*/
+void HD44780HostBus::BusAdvanceUs(uint64_t us)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	AdvanceTo(clockNs + UsToNs(us));
+}
+
+/*! @brief Get the bus counters since the last reset */
+HostBusCounters_t HD44780HostBus::BusCountersGet(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	return counters;
+}
+
+/*! @brief Zero the bus counters */
+void HD44780HostBus::BusCountersReset(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	counters = HostBusCounters_t{};
+}
+
+/*!
+	@brief Print one line of bus counters since the last reset
+	@param name Label for the line
+*/
+void HD44780HostBus::BusReport(const char *name)
+{
+	HostBusCounters_t now = BusCountersGet();
+	printf("%-32s bytes %6u  transactions %5u  bus time %9.1f uS\n",
+		name, (unsigned)now.bytes, (unsigned)now.transactions, now.busTimeNs / 1000.0);
+}
+
+// Section : I2C
+
+i2c_inst_t i2c0_inst = {&hw0Registers, false};
+i2c_inst_t i2c1_inst = {&hw1Registers, false};
+
+namespace {
+/*! Links the register blocks to the block state before any constructor runs code */
+struct HostBusStart {
+	HostBusStart()
+	{
+		blocks[0].hw = &hw0Registers;
+		blocks[0].irq = I2C0_IRQ;
+		blocks[1].hw = &hw1Registers;
+		blocks[1].irq = I2C1_IRQ;
+		hostBus.BusReset();
+	}
+} hostBusStart;
+
+/*! Find the block and register number of a register */
+HostI2CBlock &RegisterOf(const HostI2CRegister *reg, size_t &index)
+{
+	const HostI2CRegister *base0 = &hw0Registers.con;
+	const HostI2CRegister *base1 = &hw1Registers.con;
+	bool second = (reg >= base1 && reg < base1 + sizeof(i2c_hw_t) / sizeof(HostI2CRegister));
+	index = reg - (second ? base1 : base0);
+	return blocks[second ? 1 : 0];
+}
+} // namespace
+
+#define HOST_I2C_REGISTER(name) (offsetof(i2c_hw_t, name) / sizeof(HostI2CRegister))
+
+HostI2CRegister &HostI2CRegister::operator=(uint32_t value)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	size_t index;
+	HostI2CBlock &block = RegisterOf(this, index);
+	_value = value;
+	switch (index)
+	{
+		case HOST_I2C_REGISTER(data_cmd):
+			// after an abort the FIFO stays flushed until the abort is cleared
+			if (block.enabled == true && block.abort == false && block.fifo.size() < FIFODepth) {
+				block.fifo.push_back({value, clockNs});
+			}
+			break;
+		case HOST_I2C_REGISTER(enable):
+			block.enabled = value & I2C_IC_ENABLE_ENABLE_BITS;
+			if (block.enabled == false) {block.fifo.clear(); block.abort = false; block.addressed = false;}
+			break;
+		case HOST_I2C_REGISTER(tar): block.tar = value; break;
+		case HOST_I2C_REGISTER(intr_mask): block.intrMask = value; break;
+		case HOST_I2C_REGISTER(tx_tl): block.txTl = value & 0xFF; break;
+		default: break;
+	}
+	InterruptsDispatch();
+	return *this;
+}
+
+HostI2CRegister::operator uint32_t() const
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	size_t index;
+	HostI2CBlock &block = RegisterOf(this, index);
+	if (index == HOST_I2C_REGISTER(status) || index == HOST_I2C_REGISTER(raw_intr_stat) ||
+		index == HOST_I2C_REGISTER(txflr)) {
+		AdvanceTo(clockNs + PollNs);
+	}
+	switch (index)
+	{
+		case HOST_I2C_REGISTER(status):
+			return (block.fifo.empty() ? I2C_IC_STATUS_TFE_BITS : 0) |
+				((block.fifo.empty() == false || block.addressed == true || block.busFreeNs > clockNs) ?
+					I2C_IC_STATUS_ACTIVITY_BITS : 0);
+		case HOST_I2C_REGISTER(txflr): return block.fifo.size();
+		case HOST_I2C_REGISTER(raw_intr_stat):
+		case HOST_I2C_REGISTER(intr_stat):
+		{
+			// (void)hw->clr_tx_abrt reads nothing on a class type, so reporting the abort clears it
+			uint32_t raw = RawInterrupts(block);
+			block.abort = false;
+			return (index == HOST_I2C_REGISTER(intr_stat)) ? (raw & block.intrMask) : raw;
+		}
+		case HOST_I2C_REGISTER(intr_mask): return block.intrMask;
+		case HOST_I2C_REGISTER(tx_tl): return block.txTl;
+		case HOST_I2C_REGISTER(tar): return block.tar;
+		case HOST_I2C_REGISTER(enable): return block.enabled;
+		case HOST_I2C_REGISTER(clr_tx_abrt):
+		{
+			bool was = block.abort;
+			block.abort = false;
+			return was;
+		}
+		default: return _value;
+	}
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	BlockOf(i2c).enabled = true;
+	return i2c_set_baudrate(i2c, baudrate);
+}
+
+void i2c_deinit(i2c_inst_t *i2c)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	BlockOf(i2c).enabled = false;
+	BlockOf(i2c).fifo.clear();
+}
+
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	BlockOf(i2c).baud = (baudrate > 0) ? baudrate : 1;
+	return BlockOf(i2c).baud;
+}
+
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool, uint timeout_us)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	HostI2CBlock &block = BlockOf(i2c);
+	uint64_t startNs = std::max(clockNs, block.busFreeNs);
+	if (hostBus.faultSDAStuck > 0) // no START while SDA is held low
+	{
+		counters.timeouts++;
+		AdvanceTo(startNs + UsToNs(timeout_us));
+		return PICO_ERROR_TIMEOUT;
+	}
+	uint64_t nowNs;
+	if (AddressPhase(block, addr, nowNs) == false) {return PICO_ERROR_GENERIC;}
+	HD44780Emulator &device = hostBus.devices[addr];
+	size_t delivered = (hostBus.faultTimeoutAfter >= 0) ? std::min(len, (size_t)hostBus.faultTimeoutAfter) : len;
+	for (size_t i = 0; i < delivered; i++)
+	{
+		nowNs += 18 * HalfBitNs(block);
+		device.EmuPortWrite(src[i], nowNs);
+		counters.bytes++;
+	}
+	if (hostBus.faultTimeoutAfter >= 0)
+	{
+		hostBus.faultTimeoutAfter = -1;
+		counters.timeouts++;
+		counters.busTimeNs += nowNs - clockNs;
+		AdvanceTo(std::max(nowNs, startNs + UsToNs(timeout_us)));
+		block.busFreeNs = clockNs;
+		return PICO_ERROR_TIMEOUT;
+	}
+	StopPhase(block, nowNs);
+	return (int)len;
+}
+
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool, uint)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	HostI2CBlock &block = BlockOf(i2c);
+	uint64_t nowNs;
+	if (AddressPhase(block, addr, nowNs) == false) {return PICO_ERROR_GENERIC;}
+	HD44780Emulator &device = hostBus.devices[addr];
+	bool tooFast = hostBus.faultMaxKHz > 0 && block.baud > hostBus.faultMaxKHz * 1000u;
+	for (size_t i = 0; i < len; i++)
+	{
+		nowNs += 18 * HalfBitNs(block);
+		dst[i] = device.EmuPortRead(nowNs) ^ (tooFast ? 0x10 : 0x00);
+		counters.readBytes++;
+	}
+	StopPhase(block, nowNs);
+	return (int)len;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+	return i2c_write_timeout_us(i2c, addr, src, len, nostop, 1000000);
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop)
+{
+	return i2c_read_timeout_us(i2c, addr, dst, len, nostop, 1000000);
+}
+
+size_t i2c_get_write_available(i2c_inst_t *i2c)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	return FIFODepth - BlockOf(i2c).fifo.size();
+}
+
+// Section : DMA
+
+int dma_claim_unused_channel(bool)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+	{
+		if (dmaChannels[channel].claimed == false)
+		{
+			dmaChannels[channel].claimed = true;
+			return channel;
+		}
+	}
+	return -1;
+}
+
+void dma_channel_unclaim(uint channel)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	dmaChannels[channel] = HostDMAChannel{};
+}
+
+bool dma_channel_is_claimed(uint channel)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	return dmaChannels[channel].claimed;
+}
+
+dma_channel_config dma_channel_get_default_config(uint)
+{
+	dma_channel_config config{};
+	config.size = DMA_SIZE_32;
+	config.readIncrement = true;
+	return config;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *config, enum dma_channel_transfer_size size) {config->size = size;}
+void channel_config_set_read_increment(dma_channel_config *config, bool increment) {config->readIncrement = increment;}
+void channel_config_set_write_increment(dma_channel_config *config, bool increment) {config->writeIncrement = increment;}
+void channel_config_set_dreq(dma_channel_config *config, uint dreq) {config->dreq = dreq;}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *writeAddress,
+	const volatile void *readAddress, uint transferCount, bool trigger)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	HostDMAChannel &dma = dmaChannels[channel];
+	dma.config = *config;
+	dma.write = writeAddress;
+	dma.read = (const volatile uint8_t *)readAddress;
+	dma.remaining = (trigger == true) ? transferCount : 0;
+	DMAPump();
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	AdvanceTo(clockNs + PollNs);
+	return dmaChannels[channel].remaining > 0;
+}
+
+void dma_channel_abort(uint channel)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	dmaChannels[channel].remaining = 0;
+}
+
+// Section : Interrupts
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	irqHandlers[num] = handler;
+}
+
+irq_handler_t irq_get_exclusive_handler(uint num)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	return irqHandlers[num];
+}
+
+bool irq_has_shared_handler(uint) {return false;}
+
+void irq_remove_handler(uint num, irq_handler_t handler)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	if (irqHandlers[num] == handler) {irqHandlers[num] = nullptr;}
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	irqEnabled[num] = enabled;
+	irqCore[num] = std::this_thread::get_id();
+	InterruptsDispatch();
+}
+
+uint32_t save_and_disable_interrupts(void)
+{
+	uint32_t status = interruptsOff;
+	interruptsOff = true;
+	return status;
+}
+
+void restore_interrupts(uint32_t status)
+{
+	interruptsOff = status;
+	if (interruptsOff == false)
+	{
+		std::lock_guard<std::recursive_mutex> lock(busLock);
+		InterruptsDispatch();
+	}
+}
+
+static spin_lock_t spinLocks[32]; /**< Stand in for the 32 SIO spin locks */
+static std::atomic<uint> spinLockStripe{16};
+
+spin_lock_t *spin_lock_instance(uint lock_num) {return &spinLocks[lock_num];}
+
+uint next_striped_spin_lock_num(void)
+{
+	uint next = spinLockStripe.load();
+	spinLockStripe.store(next == 23 ? 16 : next + 1); // striped locks are 16-23 in the SDK
+	return next;
+}
+
+uint32_t spin_lock_blocking(spin_lock_t *lock)
+{
+	uint32_t saved = save_and_disable_interrupts();
+	while (lock->test_and_set(std::memory_order_acquire)) {
+		std::this_thread::yield();
+	}
+	return saved;
+}
+
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq)
+{
+	lock->clear(std::memory_order_release);
+	restore_interrupts(saved_irq);
+}
+
+// Section : Time
+
+uint64_t time_us_64(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	return clockNs / 1000;
+}
+
+uint32_t time_us_32(void) {return (uint32_t)time_us_64();}
+absolute_time_t get_absolute_time(void) {return time_us_64();}
+absolute_time_t make_timeout_time_us(uint64_t us) {return time_us_64() + us;}
+absolute_time_t make_timeout_time_ms(uint32_t ms) {return time_us_64() + ms * 1000ull;}
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) {return t + us;}
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {return (int64_t)(to - from);}
+uint64_t to_us_since_boot(absolute_time_t t) {return t;}
+
+/*! Polling loops see the clock move on each check */
+bool time_reached(absolute_time_t t)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	AdvanceTo(clockNs + PollNs);
+	return clockNs / 1000 >= t;
+}
+
+void busy_wait_until(absolute_time_t t)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	AdvanceTo(std::max(clockNs, UsToNs(t)));
+}
+
+void busy_wait_us_32(uint32_t us) {hostBus.BusAdvanceUs(us);}
+void busy_wait_us(uint64_t us) {hostBus.BusAdvanceUs(us);}
+void busy_wait_ms(uint32_t ms) {hostBus.BusAdvanceUs(ms * 1000ull);}
+void sleep_us(uint64_t us) {hostBus.BusAdvanceUs(us);}
+void sleep_ms(uint32_t ms) {hostBus.BusAdvanceUs(ms * 1000ull);}
+
+uint32_t clock_get_hz(enum clock_index) {return 125000000;}
+
+// Section : GPIO
+
+void gpio_init(uint) {}
+void gpio_set_function(uint, uint) {}
+void gpio_pull_up(uint) {}
+void gpio_put(uint, bool) {}
+
+/*! Driving an SCL pin (odd on the RP2040) low is one clock pulse for a stuck slave */
+void gpio_set_dir(uint gpio, bool out)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	if ((gpio & 1) && out == true && hostBus.faultSDAStuck > 0) {hostBus.faultSDAStuck--;}
+}
+
+/*! SDA pins (even on the RP2040) read low while a slave holds them */
+bool gpio_get(uint gpio)
+{
+	std::lock_guard<std::recursive_mutex> lock(busLock);
+	return !((gpio & 1) == 0 && hostBus.faultSDAStuck > 0);
+}
+
+// Section : stdio
+
+bool stdio_init_all(void) {return true;}
+int putchar_raw(int c) {return putchar(c);}
+void stdio_flush(void) {fflush(stdout);}
+
+// **** EOF ****
@@ -0,0 +1,60 @@
+/*!
+	@file     HD44780_HostBus.hpp
+	@author   Gavin Lyons
+	@brief    Simulated Pico SDK I2C, DMA, interrupt and time layer for host builds of the HD44780 library.
+*/
+
+#ifndef LCD_HD44780_HOSTBUS_H
+#define LCD_HD44780_HOSTBUS_H
+
+#include <stdint.h>
+#include <map>
+#include "HD44780_Emulator.hpp"
+
+/*! Bus counters, see HD44780HostBus::BusCountersGet */
+struct HostBusCounters_t {
+	uint32_t transactions = 0; /**< Address byte to STOP, writes and reads */
+	uint32_t bytes = 0; /**< Data bytes written, without address bytes */
+	uint32_t readBytes = 0; /**< Data bytes read */
+	uint32_t nacks = 0; /**< Transactions not acknowledged, injected faults included */
+	uint32_t timeouts = 0; /**< Writes that timed out, injected faults */
+	uint32_t fifoWords = 0; /**< Words that went through a TX FIFO, DMA and interrupt driven sends */
+	uint32_t interrupts = 0; /**< Interrupt handler calls */
+	uint64_t busTimeNs = 0; /**< Time SCL was running */
+};
+
+/*!
+	@brief The simulated bus, clock and devices
+	@details The clock only moves when the code under test waits, writes or polls status, each byte
+		on the bus takes 9 SCL periods and START plus STOP one more, so results do not depend
+		on the host. A blocking write returns at the end of its STOP. The TX FIFO of each
+		I2C block drains at the same rate while the clock moves and feeds DMA and the
+		TX empty interrupt. Bytes reach the devices at the time their last bit is clocked.
+	@note One PCF8574 at 0x27 is on the bus after BusReset, add more with BusDevice.
+*/
+class HD44780HostBus {
+	public:
+		HD44780Emulator &BusDevice(uint8_t address = 0x27);
+		void BusDeviceRemove(uint8_t address);
+		void BusReset(void);
+
+		uint64_t BusNowNs(void);
+		void BusAdvanceUs(uint64_t us);
+
+		HostBusCounters_t BusCountersGet(void);
+		void BusCountersReset(void);
+		void BusReport(const char *name);
+
+		// fault injection, cleared by BusReset
+		uint16_t faultNacks = 0; /**< Next writes and reads that are not acknowledged */
+		int16_t faultTimeoutAfter = -1; /**< Next blocking write delivers this many bytes and times out, -1 = off */
+		uint8_t faultSDAStuck = 0; /**< A slave holds SDA low for this many SCL pulses, writes time out meanwhile */
+		int32_t faultAbortWord = -1; /**< TX FIFO word number (see fifoWords) that is not acknowledged, -1 = off */
+		uint16_t faultMaxKHz = 0; /**< Reads above this clock come back wrong, 0 = no limit */
+
+		std::map<uint8_t, HD44780Emulator> devices; /**< By 7 bit address */
+};
+
+extern HD44780HostBus hostBus;
+
+#endif // guard header ending
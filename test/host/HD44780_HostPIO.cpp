@@ -0,0 +1,651 @@
+/*!
+	@file     HD44780_HostPIO.cpp
+	@author   Gavin Lyons
+	@brief    Simulated PIO blocks for host builds, state machines run instruction by instruction on the bus clock.
+*/
+
+// Section : Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <map>
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "HD44780_LCD_PCF8574_I2C.pio.h"
+#include "HD44780_HostPIO.hpp"
+
+pio_hw_t host_pio0_hw;
+pio_hw_t host_pio1_hw;
+HD44780HostPIO hostPIO;
+
+// Section : Simulation state
+
+namespace {
+
+constexpr uint32_t PIOMemory = 32;
+constexpr uint32_t PIOPins = 30;
+constexpr uint8_t OSREmpty = 32; // OSR shift count once all bits are out, the pull threshold
+
+/*! One state machine */
+struct HostSM {
+	bool claimed = false;
+	bool enabled = false;
+	uint8_t pc = 0;
+	uint32_t x = 0, y = 0, osr = 0;
+	uint8_t osrCount = OSREmpty; // bits shifted out of the OSR
+	uint8_t delay = 0; // delay cycles left
+	bool irqWaiting = false; // irq wait has set its flag and waits for it to clear
+	std::deque<uint32_t> txFIFO;
+	size_t txDepth = 4;
+	uint64_t cyclePs = 8000; // one cycle of the divided clock, 125 MHz undivided
+	uint64_t nextPs = 0; // time of the next cycle
+	uint64_t cycles = 0;
+	// pin mapping and program config, see hd44780_i2c_program_init
+	uint outBase = 0, setBase = 0, inBase = 0, sideBase = 0, jmpPin = 0;
+	uint8_t sideBits = 0; // side set bits with the enable bit
+	bool sideOpt = false;
+	bool sidePindirs = false;
+	uint8_t wrapBottom = 0, wrapTop = PIOMemory - 1;
+};
+
+/*! One PIO block */
+struct HostPIOBlock {
+	pio_hw_t *hw;
+	HostSM sm[4];
+	uint16_t memory[PIOMemory];
+	uint32_t used; // instruction memory in use, bit per address
+	uint8_t irqFlags;
+	uint32_t fdebug;
+};
+
+/*! I2C slave side of the SDA and SCL pins of a state machine, the devices of hostBus answer through it */
+struct HostSlave {
+	enum State {Idle, Address, Data, Ignore};
+	State state = Idle;
+	bool scl = true, sda = true; // line levels last seen
+	bool holdSDA = false; // pulled low by the addressed slave, ACK
+	uint8_t bits = 0; // bits of this byte clocked in, 9 = in the ACK clock
+	uint8_t shift = 0;
+	uint8_t address = 0;
+	bool acked = false;
+	uint64_t startNs = 0;
+};
+
+/*! Result of one instruction */
+enum Step {StepNext, StepJump, StepStall};
+
+/*! Everything the simulator keeps */
+struct HostPIOState {
+	HostPIOBlock blocks[2] = {{&host_pio0_hw, {}, {}, 0, 0, 0}, {&host_pio1_hw, {}, {}, 0, 0, 0}};
+	bool pinDrivenLow[PIOPins] = {}; // pindir set by a state machine , outputs are held at 0
+	std::map<uint, HostSlave> slaves; // by SDA pin
+	bool logOn = false;
+	std::string log;
+};
+
+/*! Made on first use, BusReset runs from a static constructor in the bus simulator */
+HostPIOState &Sim(void)
+{
+	static HostPIOState state;
+	return state;
+}
+
+HostPIOBlock &BlockOf(PIO pio) {return Sim().blocks[pio == pio1 ? 1 : 0];}
+
+void Log(const char *text) {if (Sim().logOn == true) {Sim().log += text;}}
+
+/*! Level of a pin, pulled up unless a state machine or a slave drives it low */
+bool PinLevel(uint pin)
+{
+	if (pin >= PIOPins) {return true;}
+	if (Sim().pinDrivenLow[pin] == true) {return false;}
+	auto slave = Sim().slaves.find(pin);
+	return !(slave != Sim().slaves.end() && slave->second.holdSDA == true);
+}
+
+void SetPinDir(uint pin, bool out)
+{
+	if (pin < PIOPins) {Sim().pinDrivenLow[pin] = out;}
+}
+
+/*! Is the address acknowledged, an injected NACK is used up */
+bool Acknowledge(uint8_t address)
+{
+	if (hostBus.faultNacks > 0)
+	{
+		hostBus.faultNacks--;
+		return false;
+	}
+	auto device = hostBus.devices.find(address);
+	return device != hostBus.devices.end() && device->second.present;
+}
+
+/*! Byte clocked in, decide the ACK and pass data to the device */
+void SlaveByte(HostSlave &slave, uint64_t nowNs)
+{
+	HostBusCounters_t &counters = HostBusCounters();
+	char text[8];
+	if (slave.state == HostSlave::Address)
+	{
+		slave.address = slave.shift >> 1;
+		slave.acked = (slave.shift & 0x01) == 0 && Acknowledge(slave.address); // write only
+		if (slave.acked == true) {
+			slave.state = HostSlave::Data;
+		} else {
+			counters.nacks++;
+		}
+	} else {
+		slave.acked = true;
+		hostBus.devices[slave.address].EmuPortWrite(slave.shift, nowNs);
+		counters.bytes++;
+	}
+	snprintf(text, sizeof(text), "%02X%c", slave.shift, slave.acked ? '+' : '-');
+	Log(text);
+}
+
+/*! Follow the lines of one slave after a cycle */
+void SlaveUpdate(uint sdaPin, uint64_t nowNs)
+{
+	HostSlave &slave = Sim().slaves[sdaPin];
+	bool scl = PinLevel(sdaPin + 1);
+	bool sda = PinLevel(sdaPin);
+
+	// SDA against the SCL level before this cycle, then SCL
+	if (sda != slave.sda && slave.scl == true)
+	{
+		if (sda == false)
+		{
+			Log("S");
+			if (slave.state == HostSlave::Idle) {slave.startNs = nowNs;}
+			slave.state = HostSlave::Address;
+			slave.bits = 0;
+			slave.shift = 0;
+		} else {
+			Log("P");
+			if (slave.state != HostSlave::Idle)
+			{
+				HostBusCounters().transactions++;
+				HostBusCounters().busTimeNs += nowNs - slave.startNs;
+			}
+			slave.state = HostSlave::Idle;
+		}
+		slave.holdSDA = false;
+	}
+	if (scl != slave.scl && slave.state != HostSlave::Idle && slave.state != HostSlave::Ignore)
+	{
+		if (scl == true && slave.bits < 8)
+		{
+			slave.shift = (slave.shift << 1) | (sda ? 1 : 0);
+			slave.bits++;
+		} else if (scl == false && slave.bits == 8) {
+			SlaveByte(slave, nowNs);
+			slave.holdSDA = slave.acked;
+			slave.bits = 9;
+		} else if (scl == false && slave.bits == 9) {
+			slave.holdSDA = false;
+			slave.bits = 0;
+			if (slave.acked == false) {slave.state = HostSlave::Ignore;} // until STOP
+		}
+	}
+	slave.scl = scl;
+	slave.sda = PinLevel(sdaPin);
+}
+
+/*! IRQ flag number of an irq or wait irq index, rel adds the state machine number */
+uint8_t IRQIndex(uint16_t index, uint smIndex)
+{
+	if (index & 0x10) {return (index & 0x04) | ((index + smIndex) & 0x03);}
+	return index & 0x07;
+}
+
+/*!
+	@brief Carry out one instruction, side set and delay are done by the caller
+	@return StepStall to run it again next cycle
+*/
+Step Execute(HostPIOBlock &block, uint smIndex, uint16_t instruction)
+{
+	HostSM &sm = block.sm[smIndex];
+	uint8_t operand = instruction & 0x1F;
+	uint8_t field = (instruction >> 5) & 0x07;
+
+	switch (instruction >> 13)
+	{
+		case 0: // JMP
+		{
+			bool jump = false;
+			switch (field)
+			{
+				case 0: jump = true; break;
+				case 1: jump = (sm.x == 0); break;
+				case 2: jump = (sm.x != 0); sm.x--; break;
+				case 3: jump = (sm.y == 0); break;
+				case 4: jump = (sm.y != 0); sm.y--; break;
+				case 5: jump = (sm.x != sm.y); break;
+				case 6: jump = PinLevel(sm.jmpPin); break;
+				default: jump = (sm.osrCount < OSREmpty); break;
+			}
+			if (jump == false) {return StepNext;}
+			sm.pc = operand;
+			return StepJump;
+		}
+		case 1: // WAIT
+		{
+			bool polarity = instruction & 0x80;
+			uint8_t source = field & 0x03;
+			bool level;
+			if (source == 0) {
+				level = PinLevel(operand);
+			} else if (source == 1) {
+				level = PinLevel(sm.inBase + operand);
+			} else {
+				uint8_t flag = 1u << IRQIndex(operand, smIndex);
+				level = block.irqFlags & flag;
+				if (level == true && polarity == true) {block.irqFlags &= ~flag;}
+			}
+			return (level == polarity) ? StepNext : StepStall;
+		}
+		case 3: // OUT , shift left as set up by hd44780_i2c_program_init
+		{
+			uint8_t count = (operand == 0) ? 32 : operand;
+			uint32_t data = (count == 32) ? sm.osr : (sm.osr >> (32 - count));
+			sm.osr = (count == 32) ? 0 : (sm.osr << count);
+			sm.osrCount = (sm.osrCount + count > OSREmpty) ? OSREmpty : sm.osrCount + count;
+			switch (field)
+			{
+				case 1: sm.x = data; break;
+				case 2: sm.y = data; break;
+				case 4:
+					for (uint8_t i = 0; i < count; i++) {SetPinDir(sm.outBase + i, (data >> i) & 1);}
+				break;
+				case 5: sm.pc = data & 0x1F; return StepJump;
+				default: break; // pins are held at 0, null, isr and exec are not used
+			}
+			return StepNext;
+		}
+		case 4: // PULL , PUSH is not used
+		{
+			if (!(instruction & 0x80)) {return StepNext;}
+			bool ifEmpty = instruction & 0x40;
+			bool blocking = instruction & 0x20;
+			if (ifEmpty == true && sm.osrCount < OSREmpty) {return StepNext;}
+			HostDMAPump();
+			if (sm.txFIFO.empty())
+			{
+				if (blocking == false)
+				{
+					sm.osr = sm.x;
+					sm.osrCount = 0;
+					return StepNext;
+				}
+				block.fdebug |= 1u << (PIO_FDEBUG_TXSTALL_LSB + smIndex);
+				return StepStall;
+			}
+			sm.osr = sm.txFIFO.front();
+			sm.txFIFO.pop_front();
+			sm.osrCount = 0;
+			HostDMAPump();
+			return StepNext;
+		}
+		case 5: // MOV , nop is mov y, y
+		{
+			uint8_t source = instruction & 0x07;
+			uint8_t operation = (instruction >> 3) & 0x03;
+			uint32_t value = 0;
+			if (source == 1) {value = sm.x;}
+			else if (source == 2) {value = sm.y;}
+			else if (source == 7) {value = sm.osr;}
+			if (operation == 1) {value = ~value;}
+			if (operation == 2)
+			{
+				uint32_t reversed = 0;
+				for (uint8_t i = 0; i < 32; i++) {reversed |= ((value >> i) & 1) << (31 - i);}
+				value = reversed;
+			}
+			switch (field)
+			{
+				case 1: sm.x = value; break;
+				case 2: sm.y = value; break;
+				case 5: sm.pc = value & 0x1F; return StepJump;
+				case 7: sm.osr = value; sm.osrCount = 0; break;
+				default: break;
+			}
+			return StepNext;
+		}
+		case 6: // IRQ
+		{
+			uint8_t flag = 1u << IRQIndex(operand, smIndex);
+			if (instruction & 0x40)
+			{
+				block.irqFlags &= ~flag;
+				return StepNext;
+			}
+			if (sm.irqWaiting == true)
+			{
+				if (block.irqFlags & flag) {return StepStall;}
+				sm.irqWaiting = false;
+				return StepNext;
+			}
+			block.irqFlags |= flag;
+			if (instruction & 0x20)
+			{
+				sm.irqWaiting = true;
+				return StepStall;
+			}
+			return StepNext;
+		}
+		case 7: // SET , one set pin
+			switch (field)
+			{
+				case 1: sm.x = operand; break;
+				case 2: sm.y = operand; break;
+				case 4: SetPinDir(sm.setBase, operand & 1); break;
+				default: break;
+			}
+			return StepNext;
+		default: // IN is not used
+			return StepNext;
+	}
+}
+
+/*!
+	@brief Run one cycle of a state machine
+	@return true if it is stalled on an empty TX FIFO, nothing changes until it is fed
+*/
+bool Cycle(HostPIOBlock &block, uint smIndex, uint64_t nowNs)
+{
+	HostSM &sm = block.sm[smIndex];
+	sm.cycles++;
+	if (sm.delay > 0)
+	{
+		sm.delay--;
+		return false;
+	}
+	uint16_t instruction = block.memory[sm.pc];
+	uint8_t delayBits = 5 - sm.sideBits;
+
+	// side set is asserted even while the instruction stalls
+	if (sm.sideBits > 0 && (sm.sideOpt == false || (instruction & 0x1000)))
+	{
+		uint8_t valueBits = sm.sideBits - (sm.sideOpt ? 1 : 0);
+		uint8_t value = (instruction >> (8 + delayBits)) & ((1u << valueBits) - 1);
+		for (uint8_t i = 0; i < valueBits && sm.sidePindirs == true; i++) {SetPinDir(sm.sideBase + i, (value >> i) & 1);}
+	}
+
+	uint8_t pc = sm.pc;
+	Step step = Execute(block, smIndex, instruction);
+	SlaveUpdate(sm.setBase, nowNs);
+	if (step == StepStall) {return (instruction & 0xE0A0) == 0x80A0 && sm.txFIFO.empty();}
+	if (step == StepNext) {sm.pc = (pc == sm.wrapTop) ? sm.wrapBottom : (pc + 1) % PIOMemory;}
+	sm.delay = (instruction >> 8) & ((1u << delayBits) - 1);
+	return false;
+}
+
+/*! Lowest free offset from the top of memory, as the SDK places programs , -1 if no room */
+int FindOffset(const HostPIOBlock &block, const pio_program_t *program)
+{
+	uint32_t mask = (program->length >= 32) ? 0xFFFFFFFFu : ((1u << program->length) - 1);
+	if (program->origin >= 0) {
+		return (block.used & (mask << program->origin)) ? -1 : program->origin;
+	}
+	for (int offset = PIOMemory - program->length; offset >= 0; offset--) {
+		if ((block.used & (mask << offset)) == 0) {return offset;}
+	}
+	return -1;
+}
+
+} // namespace
+
+// Section : Bus hooks
+
+/*!
+	@brief Run the enabled state machines up to a time, called as the bus clock moves
+	@param untilNs New time of the bus clock
+*/
+void HostPIORun(uint64_t untilNs)
+{
+	uint64_t untilPs = untilNs * 1000;
+	for (HostPIOBlock &block : Sim().blocks)
+	{
+		for (uint smIndex = 0; smIndex < 4; smIndex++)
+		{
+			HostSM &sm = block.sm[smIndex];
+			while (sm.enabled == true && sm.nextPs <= untilPs)
+			{
+				bool waiting = Cycle(block, smIndex, sm.nextPs / 1000);
+				sm.nextPs += sm.cyclePs;
+				if (waiting == true && sm.nextPs <= untilPs) // skip to the end , only the CPU or DMA can feed it
+				{
+					uint64_t skipped = (untilPs - sm.nextPs) / sm.cyclePs + 1;
+					sm.cycles += skipped;
+					sm.nextPs += skipped * sm.cyclePs;
+				}
+			}
+		}
+	}
+}
+
+/*!
+	@brief A DMA transfer paced by a PIO DREQ
+	@param dreq DREQ of the channel, see pio_get_dreq
+	@param word Word to write to the TX FIFO
+	@return false if the FIFO is full or the DREQ is not a PIO TX one
+*/
+bool HostPIODMAWrite(uint dreq, uint32_t word)
+{
+	if (dreq >= 16 || (dreq & 0x04)) {return false;}
+	HostSM &sm = Sim().blocks[dreq >> 3].sm[dreq & 0x03];
+	if (sm.txFIFO.size() >= sm.txDepth) {return false;}
+	sm.txFIFO.push_back(word);
+	return true;
+}
+
+/*! Back to power on state, called by BusReset */
+void HostPIOReset(void)
+{
+	for (HostPIOBlock &block : Sim().blocks)
+	{
+		for (HostSM &sm : block.sm) {sm = HostSM{};}
+		memset(block.memory, 0, sizeof(block.memory));
+		block.used = 0;
+		block.irqFlags = 0;
+		block.fdebug = 0;
+	}
+	memset(Sim().pinDrivenLow, 0, sizeof(Sim().pinDrivenLow));
+	Sim().slaves.clear();
+	Sim().log.clear();
+}
+
+// Section : HD44780HostPIO
+
+/*!
+	@brief Turn the slave log on or off
+	@param OnOff true = record what the slaves see
+*/
+void HD44780HostPIO::PIOLogSet(bool OnOff)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	Sim().logOn = OnOff;
+}
+
+/*! @brief Get the slave log since the last clear */
+std::string HD44780HostPIO::PIOLogGet(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	return Sim().log;
+}
+
+/*! @brief Empty the slave log */
+void HD44780HostPIO::PIOLogClear(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	Sim().log.clear();
+}
+
+/*!
+	@brief Get the cycles a state machine has run
+	@param pio PIO instance
+	@param sm State machine 0-3
+	@return Cycles of its divided clock since it was set up
+*/
+uint64_t HD44780HostPIO::PIOCyclesGet(PIO pio, uint sm)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	return BlockOf(pio).sm[sm].cycles;
+}
+
+// Section : PIO SDK
+
+HostPIODebugRegister &HostPIODebugRegister::operator=(uint32_t value)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	HostPIOBlock &block = (this == &host_pio1_hw.fdebug) ? Sim().blocks[1] : Sim().blocks[0];
+	block.fdebug &= ~value; // write 1 to clear
+	_value = block.fdebug;
+	return *this;
+}
+
+HostPIODebugRegister::operator uint32_t() const
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	return (this == &host_pio1_hw.fdebug) ? Sim().blocks[1].fdebug : Sim().blocks[0].fdebug;
+}
+
+bool pio_can_add_program(PIO pio, const pio_program_t *program)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	return FindOffset(BlockOf(pio), program) >= 0;
+}
+
+/*! Load a program, JMP targets are moved by the offset */
+uint pio_add_program(PIO pio, const pio_program_t *program)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	HostPIOBlock &block = BlockOf(pio);
+	int offset = FindOffset(block, program);
+	if (offset < 0) {return 0;}
+	for (uint8_t i = 0; i < program->length; i++)
+	{
+		uint16_t instruction = program->instructions[i];
+		block.memory[offset + i] = ((instruction & 0xE000) == 0) ? instruction + offset : instruction;
+		block.used |= 1u << (offset + i);
+	}
+	return offset;
+}
+
+void pio_remove_program(PIO pio, const pio_program_t *program, uint offset)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	for (uint8_t i = 0; i < program->length; i++) {BlockOf(pio).used &= ~(1u << (offset + i));}
+}
+
+void pio_sm_claim(PIO pio, uint sm)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	if (BlockOf(pio).sm[sm].claimed) { // the SDK panics
+		fprintf(stderr, "pio_sm_claim: state machine %u already claimed\n", sm);
+		abort();
+	}
+	BlockOf(pio).sm[sm].claimed = true;
+}
+
+void pio_sm_unclaim(PIO pio, uint sm)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	BlockOf(pio).sm[sm].claimed = false;
+}
+
+bool pio_sm_is_claimed(PIO pio, uint sm)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	return BlockOf(pio).sm[sm].claimed;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	HostSM &state = BlockOf(pio).sm[sm];
+	if (enabled == true && state.enabled == false) {state.nextPs = hostBus.BusNowNs() * 1000;}
+	state.enabled = enabled;
+}
+
+/*! Wait for room in the TX FIFO, the clock moves on while the state machine runs */
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	HostSM &state = BlockOf(pio).sm[sm];
+	while (state.txFIFO.size() >= state.txDepth && state.enabled == true) {hostBus.BusAdvanceUs(1);}
+	if (state.txFIFO.size() < state.txDepth) {state.txFIFO.push_back(data);}
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool isTx) {return (pio == pio1 ? 8 : 0) + sm + (isTx ? 0 : 4);}
+
+bool pio_interrupt_get(PIO pio, uint num)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	return BlockOf(pio).irqFlags & (1u << num);
+}
+
+void pio_interrupt_clear(PIO pio, uint num)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	BlockOf(pio).irqFlags &= ~(1u << num);
+}
+
+void pio_sm_clear_fifos(PIO pio, uint sm)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	BlockOf(pio).sm[sm].txFIFO.clear();
+}
+
+/*! Clear shift counters, delay, stall and IRQ wait state, the program counter is kept */
+void pio_sm_restart(PIO pio, uint sm)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	HostSM &state = BlockOf(pio).sm[sm];
+	state.osrCount = OSREmpty;
+	state.delay = 0;
+	state.irqWaiting = false;
+}
+
+/*! Run an instruction at once, the program counter only moves if it jumps */
+void pio_sm_exec(PIO pio, uint sm, uint instruction)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	Execute(BlockOf(pio), sm, instruction);
+}
+
+/*!
+	@brief Same set up as the c-sdk block of HD44780_LCD_PCF8574_I2C.pio
+	@param pio PIO instance
+	@param sm state machine
+	@param offset program offset from pio_add_program
+	@param sda SDA pin , SCL is sda + 1
+	@param freqKHz SCL clock in KHz, 32 cycles per SCL period
+*/
+void hd44780_i2c_program_init(PIO pio, uint sm, uint offset, uint sda, uint freqKHz)
+{
+	std::lock_guard<std::recursive_mutex> lock(HostBusLock());
+	HostSM &state = BlockOf(pio).sm[sm];
+	bool claimed = state.claimed;
+	state = HostSM{};
+	state.claimed = claimed;
+	state.outBase = state.setBase = state.inBase = state.jmpPin = sda;
+	state.sideBase = sda + 1;
+	state.sideBits = 2; // .side_set 1 opt pindirs
+	state.sideOpt = true;
+	state.sidePindirs = true;
+	state.wrapBottom = offset + hd44780_i2c_wrap_target;
+	state.wrapTop = offset + hd44780_i2c_wrap;
+	state.txDepth = 8; // PIO_FIFO_JOIN_TX
+	float divider = (float)clock_get_hz(clk_sys) / (32.0f * freqKHz * 1000);
+	state.cyclePs = (uint64_t)(divider * 1e12 / clock_get_hz(clk_sys) + 0.5);
+	state.pc = offset + hd44780_i2c_offset_entry_point;
+
+	SetPinDir(sda, false);
+	SetPinDir(sda + 1, false);
+	Sim().slaves[sda] = HostSlave{};
+	pio_sm_set_enabled(pio, sm, true);
+}
+
+// **** EOF ****
@@ -0,0 +1,45 @@
+/*!
+	@file     HD44780_HostPIO.hpp
+	@author   Gavin Lyons
+	@brief    Simulated PIO blocks for host builds, state machines run instruction by instruction on the bus clock.
+*/
+
+#ifndef LCD_HD44780_HOSTPIO_H
+#define LCD_HD44780_HOSTPIO_H
+
+#include <stdint.h>
+#include <mutex>
+#include <string>
+#include "hardware/pio.h"
+#include "HD44780_HostBus.hpp"
+
+/*!
+	@brief The simulated PIO blocks and the I2C slaves on their pins
+	@details Each enabled state machine runs one instruction per cycle of its clock divider,
+		with side set, delays, stalls, wrap, IRQ flags and a TX FIFO fed by the CPU or DMA.
+		Pins are open drain, a pin is low while a state machine drives its pindir or a
+		slave holds it. The devices of hostBus sit on the SDA and SCL pins of each
+		state machine and follow START, address, data, ACK and STOP bit by bit.
+		The log shows what the slaves saw, S = START, each byte in hex then + for ACK
+		or - for NACK, P = STOP.
+	@note hostBus.faultNacks also NACKs PIO address bytes.
+*/
+class HD44780HostPIO {
+	public:
+		void PIOLogSet(bool OnOff);
+		std::string PIOLogGet(void);
+		void PIOLogClear(void);
+		uint64_t PIOCyclesGet(PIO pio, uint sm);
+};
+
+extern HD44780HostPIO hostPIO;
+
+// Between the bus and PIO simulators, not for tests
+std::recursive_mutex &HostBusLock(void);
+HostBusCounters_t &HostBusCounters(void);
+void HostDMAPump(void);
+void HostPIORun(uint64_t untilNs);
+bool HostPIODMAWrite(uint dreq, uint32_t word);
+void HostPIOReset(void);
+
+#endif // guard header ending
@@ -0,0 +1,285 @@
+/*!
+	@file     HostBench.cpp
+	@author   Gavin Lyons
+	@brief    Bus cost of common API calls on the host emulator, bytes, transactions and modelled bus time.
+	@details Same calls as examples/Benchmark for a 20 column 4 row LCD at 100 KHz.
+		Numbers are per call and do not depend on the host, so runs can be compared in CI.
+		The formatting section times Print against the baseline copy in HostPrintBaseline,
+		and the encode section LCDEncode over 4 KB against the old nibble loop, both
+		with the host clock, those times only compare with each other on one machine.
+*/
+
+// Section: Included library
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "pico/stdlib.h"
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostPrintBaseline.hpp"
+
+// Section: Defines
+#define BENCH_LOOPS 10
+#define CLOCK_PIN 19
+#define DATA_PIN  18
+#define CLOCK_SPEED 100
+#define I2C_ADDRESS 0x27
+#define FORMAT_LOOPS 20000
+#define ENCODE_SIZE 4096
+#define ENCODE_LOOPS 200
+
+/*!
+	@brief Print or the baseline writing into a buffer, write() calls are counted
+	@details Byte writes are what the baseline sends per digit, buffer writes what the
+		LCD turns into one I2C transaction.
+*/
+template <class Base> class BenchSink : public Base {
+	public:
+		using Base::write;
+		size_t write(uint8_t character) override
+		{
+			byteWrites++;
+			if (length < sizeof(text) - 1) {text[length++] = (char)character;}
+			return 1;
+		}
+		size_t write(const uint8_t *buffer, size_t size) override
+		{
+			bufferWrites++;
+			for (size_t i = 0; i < size && length < sizeof(text) - 1; i++) {text[length++] = (char)buffer[i];}
+			return size;
+		}
+		char text[80] = {};
+		size_t length = 0;
+		uint32_t byteWrites = 0;
+		uint32_t bufferWrites = 0;
+};
+
+// Section: Function Prototypes
+void benchReport(const char *name, uint32_t loops);
+bool benchFormat(void);
+bool benchEncode(HD44780LCD &lcd);
+
+// Section: Main
+int main()
+{
+	HD44780LCD myLCD(I2C_ADDRESS, i2c1, CLOCK_SPEED, DATA_PIN, CLOCK_PIN);
+	char testString[] = "Benchmark 0123456789";
+	char rowString[] = "Temp:    21.5 C    ";
+
+	printf("HD44780 host bench, I2C clock %u kHz, results are per call.\n", CLOCK_SPEED);
+
+	hostBus.BusCountersReset();
+	if (!myLCD.LCDInit(myLCD.LCDCursorTypeOff, 4, 20)) {return 1;}
+	benchReport("LCDInit", 1);
+
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {myLCD.LCDClearScreen();}
+	benchReport("LCDClearScreen", BENCH_LOOPS);
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {myLCD.LCDClearScreenCmd();}
+	benchReport("LCDClearScreenCmd", BENCH_LOOPS);
+
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {myLCD.LCDGOTO(myLCD.LCDLineNumberTwo, 5);}
+	benchReport("LCDGOTO", BENCH_LOOPS);
+
+	uint8_t batchSize = myLCD.LCDI2CBatchSizeGet();
+	myLCD.LCDI2CBatchSizeSet(1);
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDGOTO(myLCD.LCDLineNumberOne, 0);
+		myLCD.LCDSendString(testString);
+	}
+	benchReport("20 chars, batch size 1", BENCH_LOOPS);
+	myLCD.LCDI2CBatchSizeSet(batchSize);
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDGOTO(myLCD.LCDLineNumberOne, 0);
+		myLCD.LCDSendString(testString);
+	}
+	benchReport("20 chars, batched", BENCH_LOOPS);
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {myLCD.LCDSendChar('A');}
+	benchReport("LCDSendChar", BENCH_LOOPS);
+
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		for (uint8_t row = 1; row <= 4; row++) {
+			myLCD.LCDGOTO((HD44780LCD::LCDLineNumber_e)row, 0);
+			myLCD.LCDSendString(rowString);
+		}
+	}
+	benchReport("Redraw 4 rows", BENCH_LOOPS);
+
+	myLCD.LCDBufferModeSet(true);
+	myLCD.LCDFlush();
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDGOTO(myLCD.LCDLineNumberOne, 12);
+		myLCD.print(i);
+		myLCD.LCDFlush();
+	}
+	benchReport("Buffered flush, 1 digit", BENCH_LOOPS);
+	myLCD.LCDBufferModeSet(false);
+
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDGOTO(myLCD.LCDLineNumberThree, 0);
+		myLCD.print(-12.345, 3);
+	}
+	benchReport("print(double, 3)", BENCH_LOOPS);
+	for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+		myLCD.LCDGOTO(myLCD.LCDLineNumberFour, 0);
+		myLCD.printFixed(-12345, 3);
+	}
+	benchReport("printFixed(int32_t, 3)", BENCH_LOOPS);
+
+	hostBus.BusDevice().EmuPrint(4, 20);
+	uint32_t busyWrites = hostBus.BusDevice().busyWrites;
+	printf("Writes while the controller was busy : %u\n", (unsigned)busyWrites);
+	bool formatSame = benchFormat();
+	bool encodeSame = benchEncode(myLCD);
+	return (busyWrites == 0 && formatSame && encodeSame) ? 0 : 1;
+}
+
+// Section : Functions
+
+/*!
+	@brief Print the bus cost per call since the last report and zero the counters
+	@param name Label
+	@param loops Calls made
+*/
+void benchReport(const char *name, uint32_t loops)
+{
+	HostBusCounters_t counters = hostBus.BusCountersGet();
+	printf("%-28s bytes %7.1f  transactions %6.1f  bus time %9.1f uS\n", name,
+		(double)counters.bytes / loops, (double)counters.transactions / loops,
+		counters.busTimeNs / 1000.0 / loops);
+	hostBus.BusCountersReset();
+}
+
+/*!
+	@brief Time one formatting call over a set of values, CPU only , no bus
+	@param name Label
+	@param sink Print or baseline sink
+	@param values Values printed in turn
+	@param count Number of values
+	@param call Prints one value into the sink
+	@return Text of the last pass over the values, for comparing the two sides
+*/
+template <class Sink, class Value, class Call>
+std::string benchFormatCase(const char *name, Sink &sink, const Value *values, size_t count, Call call)
+{
+	std::string text;
+	sink.byteWrites = 0;
+	sink.bufferWrites = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t loop = 0; loop < FORMAT_LOOPS; loop++) {
+		for (size_t i = 0; i < count; i++) {
+			sink.length = 0;
+			call(sink, values[i]);
+			if (loop == FORMAT_LOOPS - 1) {text.append(sink.text, sink.length).push_back(' ');}
+		}
+	}
+	double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	double calls = (double)FORMAT_LOOPS * count;
+	printf("%-28s %7.1f nS  byte writes %5.2f  buffer writes %5.2f\n", name, ns / calls,
+		sink.byteWrites / calls, sink.bufferWrites / calls);
+	return text;
+}
+
+/*!
+	@brief Formatting cost of the baseline Print number paths against the current ones
+	@return true if both print the same text for every value
+*/
+bool benchFormat(void)
+{
+	static const long integers[] = {0, 7, 42, 1234, -98765, 2147483647L, -2147483647L};
+	static const unsigned long words[] = {0x0UL, 0xAUL, 0x1F2EUL, 0xDEADBEEFUL, 0xFFFFFFFFUL};
+	static const double reals[] = {0.0, 0.5, -12.345, 3.14159, 1234.5678, -99999.99};
+	const size_t integerCount = sizeof(integers) / sizeof(integers[0]);
+	const size_t wordCount = sizeof(words) / sizeof(words[0]);
+	const size_t realCount = sizeof(reals) / sizeof(reals[0]);
+	BenchSink<HostPrintBaseline> baseline;
+	BenchSink<Print> current;
+	bool same = true;
+
+	printf("\nFormatting, host CPU time per call, baseline then current :\n");
+	auto compare = [&](const std::string &before, const std::string &after) {
+		if (before != after) {
+			printf("  output differs\n    baseline : %s\n    current  : %s\n", before.c_str(), after.c_str());
+			same = false;
+		}
+	};
+	std::string before = benchFormatCase("baseline print(long)", baseline, integers, integerCount,
+		[](auto &sink, long value) {sink.print(value);});
+	compare(before, benchFormatCase("current  print(long)", current, integers, integerCount,
+		[](auto &sink, long value) {sink.print(value);}));
+	for (int base : {16, 8, 2}) {
+		char baselineName[32], currentName[32];
+		snprintf(baselineName, sizeof(baselineName), "baseline print(ulong, %d)", base);
+		snprintf(currentName, sizeof(currentName), "current  print(ulong, %d)", base);
+		before = benchFormatCase(baselineName, baseline, words, wordCount,
+			[base](auto &sink, unsigned long value) {sink.print(value, base);});
+		compare(before, benchFormatCase(currentName, current, words, wordCount,
+			[base](auto &sink, unsigned long value) {sink.print(value, base);}));
+	}
+	for (int digits : {2, 3, 6}) {
+		char baselineName[32], currentName[32];
+		snprintf(baselineName, sizeof(baselineName), "baseline print(double, %d)", digits);
+		snprintf(currentName, sizeof(currentName), "current  print(double, %d)", digits);
+		before = benchFormatCase(baselineName, baseline, reals, realCount,
+			[digits](auto &sink, double value) {sink.print(value, digits);});
+		compare(before, benchFormatCase(currentName, current, reals, realCount,
+			[digits](auto &sink, double value) {sink.print(value, digits);}));
+	}
+	return same;
+}
+
+/*!
+	@brief Old per byte nibble split of LCDSendData and LCDSendCmd , backlight on
+	@param data Bytes to encode
+	@param length Number of bytes
+	@param isData true = RS high
+	@param buffer Four port bytes per byte
+*/
+static void benchEncodeNibbles(const uint8_t *data, size_t length, bool isData, uint8_t *buffer)
+{
+	const uint8_t byteOn = isData ? 0x0D : 0x0C;
+	const uint8_t byteOff = isData ? 0x09 : 0x08;
+	for (size_t i = 0; i < length; i++) {
+		uint8_t nibbleLower = (data[i] << 4) & 0xF0;
+		uint8_t nibbleUpper = data[i] & 0xF0;
+		*buffer++ = nibbleUpper | byteOn;
+		*buffer++ = nibbleUpper | byteOff;
+		*buffer++ = nibbleLower | byteOn;
+		*buffer++ = nibbleLower | byteOff;
+	}
+}
+
+/*!
+	@brief LCDEncode throughput over 4 KB against the old nibble loop, host CPU time
+	@param lcd Initialised LCD , backlight on
+	@return true if LCDEncode gives the same port bytes as the nibble loop
+*/
+bool benchEncode(HD44780LCD &lcd)
+{
+	static uint8_t source[ENCODE_SIZE];
+	static uint8_t encoded[4 * ENCODE_SIZE];
+	static uint8_t reference[4 * ENCODE_SIZE];
+	bool same = true;
+
+	for (size_t i = 0; i < ENCODE_SIZE; i++) {source[i] = (uint8_t)(i * 7 + (i >> 8));}
+	printf("\nEncode %u bytes, host CPU time per pass :\n", ENCODE_SIZE);
+	for (bool isData : {true, false}) {
+		auto start = std::chrono::steady_clock::now();
+		for (uint16_t loop = 0; loop < ENCODE_LOOPS; loop++) {benchEncodeNibbles(source, ENCODE_SIZE, isData, reference);}
+		double nibbleNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		start = std::chrono::steady_clock::now();
+		for (uint16_t loop = 0; loop < ENCODE_LOOPS; loop++) {lcd.LCDEncode(source, ENCODE_SIZE, isData, encoded);}
+		double tableNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		printf("%-28s %9.1f uS  %8.1f MB/s\n", isData ? "nibble loop, data" : "nibble loop, command",
+			nibbleNs / ENCODE_LOOPS / 1000.0, (double)ENCODE_SIZE * ENCODE_LOOPS * 1000.0 / nibbleNs);
+		printf("%-28s %9.1f uS  %8.1f MB/s\n", isData ? "LCDEncode, data" : "LCDEncode, command",
+			tableNs / ENCODE_LOOPS / 1000.0, (double)ENCODE_SIZE * ENCODE_LOOPS * 1000.0 / tableNs);
+		if (memcmp(encoded, reference, sizeof(encoded)) != 0) {
+			printf("  LCDEncode port bytes differ from the nibble loop\n");
+			same = false;
+		}
+	}
+	return same;
+}
+
+// *** EOF ***
@@ -0,0 +1,39 @@
+/*!
+	@file     HostPrintBaseline.hpp
+	@author   Gavin Lyons
+	@brief    The number and float formatting of Print as it was before the fixed point rework, for the host bench.
+*/
+
+#ifndef LCD_HD44780_HOSTPRINTBASELINE_H
+#define LCD_HD44780_HOSTPRINTBASELINE_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*!
+	@brief Copy of the original Print number paths , digit by digit division and soft-float loop
+	@details Only what print(long), print(unsigned long) and print(double) reach is kept.
+		write() is the same interface as Print so one sink serves both in HostBench.
+*/
+class HostPrintBaseline {
+	public:
+		virtual ~HostPrintBaseline() = default;
+		virtual size_t write(uint8_t) = 0;
+		size_t write(const char *str) {
+			if (str == NULL) return 0;
+			return write((const uint8_t *)str, strlen(str));
+		}
+		virtual size_t write(const uint8_t *buffer, size_t size);
+
+		size_t print(const char[]);
+		size_t print(char);
+		size_t print(long, int = 10);
+		size_t print(unsigned long, int = 10);
+		size_t print(double, int = 2);
+
+	private:
+		size_t printNumber(unsigned long, uint8_t);
+		size_t printFloat(double, uint8_t);
+};
+
+#endif // guard header ending
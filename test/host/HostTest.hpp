@@ -0,0 +1,31 @@
+/*!
+	@file     HostTest.hpp
+	@author   Gavin Lyons
+	@brief    Check macros for the host tests, a failed check is printed and the test exits non zero.
+*/
+
+#ifndef LCD_HD44780_HOSTTEST_H
+#define LCD_HD44780_HOSTTEST_H
+
+#include <stdio.h>
+#include <string>
+
+inline int hostTestFailures = 0;
+
+/*! Check a condition, carry on after a failure so every failure is listed */
+#define HOST_CHECK(cond) do { if (!(cond)) { hostTestFailures++; \
+	printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+/*! Check two values are equal, both are printed on failure */
+#define HOST_CHECK_EQUAL(a, b) do { auto hostA = (a); auto hostB = (b); if (!(hostA == hostB)) { \
+	hostTestFailures++; printf("%s:%d: check failed: %s == %s\n  got      : %s\n  expected : %s\n", \
+	__FILE__, __LINE__, #a, #b, HostTestString(hostA).c_str(), HostTestString(hostB).c_str()); } } while (0)
+
+inline std::string HostTestString(const std::string &value) {return "\"" + value + "\"";}
+inline std::string HostTestString(const char *value) {return HostTestString(std::string(value));}
+template <typename T> std::string HostTestString(T value) {return std::to_string(value);}
+
+/*! Result for main */
+#define HOST_TEST_END() (printf("%s: %s\n", __FILE__, hostTestFailures ? "FAILED" : "passed"), hostTestFailures ? 1 : 0)
+
+#endif // guard header ending
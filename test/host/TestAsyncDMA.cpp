@@ -0,0 +1,93 @@
+/*!
+	@file     TestAsyncDMA.cpp
+	@author   Gavin Lyons
+	@brief    Host test, async strings are queued and sent by DMA through the I2C TX FIFO.
+*/
+
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+static int callbacks = 0;
+static void asyncDone(void) {callbacks++;}
+
+/*! Run the main loop until the queue is sent , the bus moves on 50 uS a pass */
+static uint32_t pollUntilIdle(HD44780LCD &lcd)
+{
+	uint32_t polls = 0;
+	while (lcd.LCDAsyncPoll() == false && polls < 100000)
+	{
+		hostBus.BusAdvanceUs(50);
+		polls++;
+	}
+	return polls;
+}
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780LCD lcd(0x27, i2c1, 100, 18, 19);
+	HD44780Emulator &device = hostBus.BusDevice();
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOff, 2, 16));
+	HOST_CHECK(lcd.LCDAsyncInit());
+	HOST_CHECK(dma_channel_is_claimed(0));
+	lcd.LCDAsyncCallbackSet(asyncDone);
+
+	// queueing returns long before the 48 bytes have been clocked out
+	hostBus.BusCountersReset();
+	uint64_t startNs = hostBus.BusNowNs();
+	HOST_CHECK(lcd.LCDSendStringAsync("Async hello", lcd.LCDLineNumberTwo, 2));
+	HOST_CHECK(hostBus.BusNowNs() - startNs < 90000);
+	HOST_CHECK(hostBus.BusCountersGet().bytes < 48u);
+	HOST_CHECK(pollUntilIdle(lcd) > 0);
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().bytes, 48u);
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().fifoWords, 48u);
+	HOST_CHECK_EQUAL(callbacks, 1);
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "  Async hello   ");
+
+	// more than the ring holds is refused as a whole
+	HOST_CHECK(lcd.LCDSendStringAsync("0123456789012345678901234567890123456789012345678901234567890123456789") == false);
+	HOST_CHECK(lcd.LCDAsyncPoll());
+	HOST_CHECK_EQUAL(callbacks, 1);
+
+	// a blocking write waits for the queue , order is kept
+	HOST_CHECK(lcd.LCDSendStringAsync("AAAA", lcd.LCDLineNumberOne, 0));
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 2);
+	lcd.LCDSendString("bb");
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "AAbb            ");
+	HOST_CHECK(lcd.LCDAsyncPoll());
+	HOST_CHECK_EQUAL(callbacks, 2);
+
+	// abort part way , error latched and the next blocking write restores the screen
+	hostBus.faultAbortWord = hostBus.BusCountersGet().fifoWords + 6;
+	HOST_CHECK(lcd.LCDSendStringAsync("abcdef", lcd.LCDLineNumberTwo, 0));
+	pollUntilIdle(lcd);
+	HOST_CHECK(lcd.LCDAsyncErrorGet());
+	HOST_CHECK(lcd.LCDAsyncErrorGet() == false);
+	HOST_CHECK(lcd.LCDRecoverPendingGet());
+	HOST_CHECK(device.EmuRowText(2, 2, 16) != "abcdefc hello   ");
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 15);
+	lcd.LCDSendChar('!');
+	HOST_CHECK(lcd.LCDRecoverPendingGet() == false);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "AAbb           !");
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "abcdefc hello   ");
+
+	lcd.LCDAsyncDeInit();
+	HOST_CHECK(dma_channel_is_claimed(0) == false);
+	HOST_CHECK(lcd.LCDSendStringAsync("off") == false);
+
+	// the destructor hands the channel back with async mode still on
+	{
+		HD44780LCD scoped(0x27, i2c1, 100, 18, 19);
+		scoped.LCDSharedBusSet(true);
+		HOST_CHECK(scoped.LCDInit(scoped.LCDCursorTypeOff, 2, 16));
+		HOST_CHECK(scoped.LCDAsyncInit());
+		HOST_CHECK(dma_channel_is_claimed(0));
+		HOST_CHECK(scoped.LCDSendStringAsync("bye", scoped.LCDLineNumberOne, 0));
+	}
+	HOST_CHECK(dma_channel_is_claimed(0) == false);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "bye             ");
+
+	HOST_CHECK_EQUAL(device.busyWrites, 0u);
+	return HOST_TEST_END();
+}
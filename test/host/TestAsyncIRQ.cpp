@@ -0,0 +1,76 @@
+/*!
+	@file     TestAsyncIRQ.cpp
+	@author   Gavin Lyons
+	@brief    Host test, async strings are sent by the I2C TX empty interrupt and the interrupt is given back.
+*/
+
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+/*! Run the main loop until the queue is sent , the bus moves on 50 uS a pass */
+static uint32_t pollUntilIdle(HD44780LCD &lcd)
+{
+	uint32_t polls = 0;
+	while (lcd.LCDAsyncPoll() == false && polls < 100000)
+	{
+		hostBus.BusAdvanceUs(50);
+		polls++;
+	}
+	return polls;
+}
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780Emulator &device = hostBus.BusDevice();
+	HD44780LCD lcd(0x27, i2c1, 100, 18, 19);
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOff, 2, 16));
+	HOST_CHECK(lcd.LCDAsyncIRQInit());
+	HOST_CHECK(irq_get_exclusive_handler(I2C1_IRQ) != nullptr);
+	HOST_CHECK(lcd.LCDAsyncInit() == false);
+
+	// the interrupt refills the FIFO while the main loop only polls
+	hostBus.BusCountersReset();
+	HOST_CHECK(lcd.LCDSendStringAsync("IRQ refill test", lcd.LCDLineNumberOne, 0));
+	HOST_CHECK(pollUntilIdle(lcd) > 0);
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().bytes, 64u);
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().fifoWords, 64u);
+	HOST_CHECK(hostBus.BusCountersGet().interrupts > 0u);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "IRQ refill test ");
+
+	// abort drops the queue , the next blocking write resyncs and restores
+	hostBus.faultAbortWord = hostBus.BusCountersGet().fifoWords + 10;
+	HOST_CHECK(lcd.LCDSendStringAsync("abcdefgh", lcd.LCDLineNumberTwo, 0));
+	pollUntilIdle(lcd);
+	HOST_CHECK(lcd.LCDAsyncErrorGet());
+	HOST_CHECK(lcd.LCDRecoverPendingGet());
+	lcd.LCDGOTO(lcd.LCDLineNumberTwo, 15);
+	lcd.LCDSendChar('!');
+	HOST_CHECK(lcd.LCDRecoverPendingGet() == false);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "IRQ refill test ");
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "abcdefgh       !");
+
+	// one owner per I2C block , the destructor gives the interrupt back
+	{
+		HD44780LCD second(0x27, i2c1, 100, 18, 19);
+		second.LCDSharedBusSet(true);
+		HOST_CHECK(second.LCDAsyncIRQInit() == false);
+	}
+	lcd.LCDAsyncDeInit();
+	HOST_CHECK(irq_get_exclusive_handler(I2C1_IRQ) == nullptr);
+	{
+		HD44780LCD scoped(0x27, i2c1, 100, 18, 19);
+		scoped.LCDSharedBusSet(true);
+		HOST_CHECK(scoped.LCDInit(scoped.LCDCursorTypeOff, 2, 16));
+		HOST_CHECK(scoped.LCDAsyncIRQInit());
+		HOST_CHECK(scoped.LCDSendStringAsync("bye", scoped.LCDLineNumberOne, 0));
+	}
+	HOST_CHECK(irq_get_exclusive_handler(I2C1_IRQ) == nullptr);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "bye             ");
+	HOST_CHECK(lcd.LCDAsyncIRQInit());
+	lcd.LCDAsyncDeInit();
+
+	HOST_CHECK_EQUAL(device.busyWrites, 0u);
+	return HOST_TEST_END();
+}
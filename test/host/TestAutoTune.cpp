@@ -0,0 +1,49 @@
+/*!
+	@file     TestAutoTune.cpp
+	@author   Gavin Lyons
+	@brief    Host test, LCDAutoTuneClock keeps one step of margin below the highest rate that passed.
+*/
+
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+/*! Tune a freshly initialised LCD and check the text still arrives at the chosen rate */
+static uint16_t tune(uint16_t startKHz, uint16_t maxKHz)
+{
+	HD44780LCD lcd(0x27, i2c1, startKHz, 18, 19);
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOff, 2, 16));
+	uint16_t chosen = lcd.LCDAutoTuneClock(maxKHz);
+	HOST_CHECK_EQUAL(lcd.LCDClockSpeedGet(), chosen);
+	lcd.LCDSendString("tuned");
+	HOST_CHECK_EQUAL(hostBus.BusDevice().EmuRowText(1, 2, 16), "tuned           ");
+	return chosen;
+}
+
+int main()
+{
+	// every rate passes , the last one is still not used
+	hostBus.BusReset();
+	HOST_CHECK_EQUAL(tune(100, 1000), (uint16_t)800);
+	hostBus.BusReset();
+	HOST_CHECK_EQUAL(tune(100, 400), (uint16_t)300);
+	hostBus.BusReset();
+	HOST_CHECK_EQUAL(tune(100, 450), (uint16_t)300);
+
+	// reads above 450 KHz come back wrong , 400 is the highest good rate
+	hostBus.BusReset();
+	hostBus.faultMaxKHz = 450;
+	HOST_CHECK_EQUAL(tune(100, 1000), (uint16_t)300);
+
+	// never below the rate at the start
+	hostBus.BusReset();
+	HOST_CHECK_EQUAL(tune(100, 100), (uint16_t)100);
+	hostBus.BusReset();
+	HOST_CHECK_EQUAL(tune(400, 500), (uint16_t)400);
+	hostBus.BusReset();
+	hostBus.faultMaxKHz = 350;
+	HOST_CHECK_EQUAL(tune(400, 1000), (uint16_t)400);
+
+	HOST_CHECK_EQUAL(hostBus.BusDevice().busyWrites, 0u);
+	return HOST_TEST_END();
+}
@@ -0,0 +1,138 @@
+/*!
+	@file     TestBufferedFlush.cpp
+	@author   Gavin Lyons
+	@brief    Host test, buffered mode flush sends only changed characters within the byte budget.
+*/
+
+#include <string.h>
+#include "hd44780/HD44780_LCD_PCF8574_GlyphCache.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780LCD lcd(0x27, i2c1, 100, 18, 19);
+	HD44780Emulator &device = hostBus.BusDevice();
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOff, 4, 20));
+	lcd.LCDBufferModeSet(true);
+
+	// writes only touch the frame buffer
+	hostBus.BusCountersReset();
+	for (uint8_t row = 1; row <= 4; row++)
+	{
+		lcd.LCDGOTO((HD44780LCD::LCDLineNumber_e)row, 0);
+		lcd.print("Temp: 12.5 C  row ");
+		lcd.print(row);
+	}
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().bytes, 0u);
+	HOST_CHECK(lcd.LCDBufferDirtyGet());
+
+	// first flush sends every row , return value is the bus bytes
+	uint16_t sent = lcd.LCDFlush();
+	HOST_CHECK_EQUAL((uint32_t)sent, hostBus.BusCountersGet().bytes);
+	HOST_CHECK(sent > 0);
+	HOST_CHECK_EQUAL(device.EmuRowText(3, 4, 20), "Temp: 12.5 C  row 3 ");
+	HOST_CHECK(lcd.LCDBufferDirtyGet() == false);
+
+	// nothing changed , nothing sent
+	hostBus.BusCountersReset();
+	HOST_CHECK_EQUAL(lcd.LCDFlush(), 0);
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().bytes, 0u);
+
+	// same text written again is not a change
+	lcd.LCDGOTO(lcd.LCDLineNumberTwo, 0);
+	lcd.print("Temp: 12.5");
+	HOST_CHECK_EQUAL(lcd.LCDFlush(), 0);
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().bytes, 0u);
+
+	// 12.5 to 13.7 , two single character runs of address + character , 8 bytes each
+	lcd.LCDGOTO(lcd.LCDLineNumberThree, 6);
+	lcd.print("13.7");
+	sent = lcd.LCDFlush();
+	HOST_CHECK_EQUAL(sent, 16);
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().bytes, 16u);
+	HOST_CHECK_EQUAL(device.EmuRowText(3, 4, 20), "Temp: 13.7 C  row 3 ");
+
+	// a budget cuts the flush , the rest goes out on the next call
+	hostBus.BusCountersReset();
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 0);
+	lcd.print("ABCDEFGHIJKLMNOPQRST");
+	sent = lcd.LCDFlush(24);
+	HOST_CHECK(sent <= 24);
+	HOST_CHECK_EQUAL((uint32_t)sent, hostBus.BusCountersGet().bytes);
+	HOST_CHECK(lcd.LCDBufferDirtyGet());
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 4, 20).substr(0, 5), "ABCDE");
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 4, 20).substr(11), "C  row 1 ");
+	while (lcd.LCDBufferDirtyGet()) {lcd.LCDFlush(24);}
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 4, 20), "ABCDEFGHIJKLMNOPQRST");
+
+	// clear line goes through the buffer as well
+	lcd.LCDClearLine(lcd.LCDLineNumberFour);
+	lcd.LCDFlush();
+	HOST_CHECK_EQUAL(device.EmuRowText(4, 4, 20), std::string(20, ' '));
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 4, 20), "Temp: 12.5 C  row 2 ");
+
+	// glyph cache , a glyph still on the LCD until the next flush is not replaced
+	uint8_t glyphs[9][8];
+	for (uint8_t i = 0; i < 9; i++) {memset(glyphs[i], i + 1, 8);}
+	HD44780LCDGlyphCache cache(lcd);
+	lcd.LCDGOTO(lcd.LCDLineNumberFour, 0);
+	for (uint8_t i = 0; i < 8; i++) {HOST_CHECK(cache.LCDGlyphPrint(glyphs[i]));}
+	lcd.LCDFlush();
+	HOST_CHECK_EQUAL(cache.LCDGlyphUploadsGet(), 8u);
+	lcd.LCDGOTO(lcd.LCDLineNumberFour, 0);
+	lcd.print(' ');
+	HOST_CHECK_EQUAL(cache.LCDGlyphAcquire(glyphs[8]), -1);
+	lcd.LCDFlush();
+	HOST_CHECK_EQUAL(cache.LCDGlyphAcquire(glyphs[8]), 0);
+	HOST_CHECK_EQUAL(device.cgram[0], 9);
+
+	// a bitmap changed in place is a new glyph , found by content not by pointer
+	memset(glyphs[8], 0x1F, 8);
+	HOST_CHECK_EQUAL(cache.LCDGlyphAcquire(glyphs[8]), 0);
+	HOST_CHECK_EQUAL(cache.LCDGlyphUploadsGet(), 10u);
+	HOST_CHECK_EQUAL(device.cgram[7], 0x1F);
+	memcpy(glyphs[8], glyphs[1], 8);
+	HOST_CHECK_EQUAL(cache.LCDGlyphAcquire(glyphs[8]), 1);
+	HOST_CHECK_EQUAL(cache.LCDGlyphUploadsGet(), 10u);
+
+	// the flush budget holds the address that brings the counter back from CGRAM
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 0);
+	lcd.print('T');
+	lcd.LCDFlush();
+	lcd.print('e');
+	lcd.LCDCreateCustomChar(7, glyphs[0]);
+	hostBus.BusCountersReset();
+	HOST_CHECK_EQUAL(lcd.LCDFlush(4), (uint16_t)0);
+	HOST_CHECK_EQUAL(lcd.LCDFlush(8), (uint16_t)8);
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().bytes, 8u);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 4, 20).substr(0, 2), "Te");
+
+	HOST_CHECK_EQUAL(device.busyWrites, 0u);
+
+	// screen content never cleared so not known , glyphs written there are not replaced
+	HD44780Emulator &other = hostBus.BusDevice(0x26);
+	HD44780LCD unknown(0x26, i2c1, 100, 18, 19);
+	HD44780LCDGlyphCache unknownCache(unknown);
+	for (uint8_t i = 0; i < 8; i++) {HOST_CHECK_EQUAL(unknownCache.LCDGlyphAcquire(glyphs[i]), (int8_t)i);}
+	unknown.LCDGOTO(unknown.LCDLineNumberOne, 0);
+	for (uint8_t i = 0; i < 8; i++) {unknown.LCDPrintCustomChar(i);}
+	HOST_CHECK_EQUAL(other.ddram[0], 0);
+	memset(glyphs[8], 0x0E, 8);
+	HOST_CHECK_EQUAL(unknownCache.LCDGlyphAcquire(glyphs[8]), -1);
+	unknown.LCDClearScreenCmd();
+	HOST_CHECK_EQUAL(unknownCache.LCDGlyphAcquire(glyphs[8]), 0);
+
+	// a shifted display can show any DDRAM column , nothing is replaced until it is home
+	lcd.LCDBufferModeSet(false);
+	lcd.LCDClearScreenCmd();
+	HOST_CHECK_EQUAL(cache.LCDGlyphAcquire(glyphs[2]), 2);
+	HOST_CHECK_EQUAL(cache.LCDGlyphAcquire(glyphs[3]), 3);
+	lcd.LCDScroll(lcd.LCDMoveLeft, 1);
+	memset(glyphs[8], 0x11, 8);
+	HOST_CHECK_EQUAL(cache.LCDGlyphAcquire(glyphs[8]), -1);
+	lcd.LCDHome();
+	HOST_CHECK(cache.LCDGlyphAcquire(glyphs[8]) >= 0);
+	return HOST_TEST_END();
+}
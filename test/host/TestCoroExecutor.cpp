@@ -0,0 +1,132 @@
+/*!
+	@file     TestCoroExecutor.cpp
+	@author   Gavin Lyons
+	@brief    Host test, coroutine tasks on the polled executor with the simulated clock.
+*/
+
+#include <vector>
+#include "hd44780/HD44780_LCD_PCF8574_Coro.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+#define POLL_US 100
+
+static std::vector<std::string> events; /**< What the tasks did , in order */
+static uint64_t row2At = 0; /**< Time the second row was written */
+static uint64_t delayFrom = 0; /**< Time the UI task started its delay */
+
+/*! UI task , clear , two rows with a delay between */
+static HD44780LCDTask uiTask(HD44780LCDAwait &lcd)
+{
+	events.push_back("clear");
+	co_await lcd.clear();
+	events.push_back("cleared");
+	co_await lcd.writeLine(HD44780LCD::LCDLineNumberOne, "Hello");
+	events.push_back("row 1");
+	delayFrom = time_us_64();
+	co_await lcd.delay(10000);
+	co_await lcd.writeLine(HD44780LCD::LCDLineNumberTwo, "World", HD44780LCD::LCDAlignRight);
+	row2At = time_us_64();
+	events.push_back("row 2");
+}
+
+/*! Sensor task , runs between the UI steps */
+static HD44780LCDTask sensorTask(HD44780LCDAwait &lcd, int reads)
+{
+	for (int i = 0; i < reads; i++)
+	{
+		events.push_back("sensor");
+		co_await lcd.delay(1000);
+	}
+}
+
+/*! Task that only waits */
+static HD44780LCDTask idleTask(HD44780LCDAwait &lcd)
+{
+	co_await lcd.delay(1);
+}
+
+/*!
+	@brief Poll the executor until every task is done , the bus moves on POLL_US a pass
+	@param executor Executor to poll
+	@param maxPollUs Returns the longest simulated time spent inside one poll
+	@return Polls made
+*/
+static uint32_t runExecutor(HD44780LCDExecutor &executor, uint64_t &maxPollUs)
+{
+	uint32_t polls = 0;
+	maxPollUs = 0;
+	while (polls < 100000)
+	{
+		uint64_t start = time_us_64();
+		uint8_t running = executor.LCDExecutorPoll(start);
+		uint64_t spent = time_us_64() - start;
+		if (spent > maxPollUs) {maxPollUs = spent;}
+		polls++;
+		if (running == 0) {break;}
+		hostBus.BusAdvanceUs(POLL_US);
+	}
+	return polls;
+}
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780Emulator &device = hostBus.BusDevice();
+	HD44780LCD lcd(0x27, i2c1, 400, 18, 19);
+	HD44780LCDAwait lcdAwait(lcd);
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOff, 2, 16));
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 0);
+	lcd.LCDSendString("old text");
+
+	// the sensor task runs while the UI task waits for the clear
+	HD44780LCDExecutor executor;
+	HOST_CHECK(executor.LCDExecutorSpawn(uiTask(lcdAwait)));
+	HOST_CHECK(executor.LCDExecutorSpawn(sensorTask(lcdAwait, 5)));
+	HOST_CHECK_EQUAL(executor.LCDExecutorCountGet(), (uint8_t)2);
+	uint64_t maxPollUs;
+	uint32_t polls = runExecutor(executor, maxPollUs);
+	HOST_CHECK(polls > 10u);
+	HOST_CHECK(maxPollUs < 1520u); // no poll sat out the clear
+	HOST_CHECK_EQUAL(events.size(), (size_t)9);
+	HOST_CHECK_EQUAL(events.front(), "clear");
+	HOST_CHECK_EQUAL(events.back(), "row 2");
+	HOST_CHECK(events.size() > 2 && events[1] == "sensor" && events[2] == "sensor"); // clear still running 1 mS later
+	HOST_CHECK(row2At >= delayFrom + 10000);
+	HOST_CHECK(row2At < delayFrom + 10000 + 4 * POLL_US);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "Hello           ");
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "           World");
+
+	// buffered mode , a row is flushed a few characters per poll
+	lcd.LCDBufferModeSet(true);
+	HOST_CHECK(executor.LCDExecutorSpawn([](HD44780LCDAwait &lcd) -> HD44780LCDTask {
+		co_await lcd.writeLine(HD44780LCD::LCDLineNumberTwo, "Step by step 16", HD44780LCD::LCDAlignLeft, 16);
+	}(lcdAwait)));
+	hostBus.BusCountersReset();
+	uint32_t flushPolls = 0;
+	uint32_t maxBytes = 0;
+	while (executor.LCDExecutorCountGet() > 0 && flushPolls < 1000)
+	{
+		uint32_t before = hostBus.BusCountersGet().bytes;
+		executor.LCDExecutorPoll(time_us_64());
+		uint32_t sent = hostBus.BusCountersGet().bytes - before;
+		if (sent > maxBytes) {maxBytes = sent;}
+		hostBus.BusAdvanceUs(POLL_US);
+		flushPolls++;
+	}
+	HOST_CHECK(flushPolls >= 4u);
+	HOST_CHECK(maxBytes <= 16u + 4u); // one address command may go with the step
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "Step by step 16 ");
+	lcd.LCDBufferModeSet(false);
+
+	// one slot per task , a full executor refuses and destroys the task
+	for (uint8_t i = 0; i < HD44780LCDExecutor::LCDExecutorMaxTasks; i++) {
+		HOST_CHECK(executor.LCDExecutorSpawn(idleTask(lcdAwait)));
+	}
+	HOST_CHECK(executor.LCDExecutorSpawn(idleTask(lcdAwait)) == false);
+	runExecutor(executor, maxPollUs);
+	HOST_CHECK_EQUAL(executor.LCDExecutorCountGet(), (uint8_t)0);
+
+	HOST_CHECK_EQUAL(device.busyWrites, 0u);
+	return HOST_TEST_END();
+}
@@ -0,0 +1,162 @@
+/*!
+	@file     TestDeferFold.cpp
+	@author   Gavin Lyons
+	@brief    Host test, deferred mode against direct mode on random call sequences.
+	@details Two LCDs on one bus get the same calls, one direct and one in deferred mode.
+		After each sequence both controllers must be in the same state, the folded
+		stream must never cost more bytes on the bus.
+*/
+
+#include <string.h>
+#include <random>
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+#define SEQUENCES 200
+#define CALLS 40
+
+/*! Compare everything the display shows or will use next */
+static bool sameState(const HD44780Emulator &a, const HD44780Emulator &b)
+{
+	return memcmp(a.ddram, b.ddram, sizeof(a.ddram)) == 0 && memcmp(a.cgram, b.cgram, sizeof(a.cgram)) == 0 &&
+		a.addressCounter == b.addressCounter && a.cgramSelected == b.cgramSelected &&
+		a.displayShift == b.displayShift && a.displayControl == b.displayControl &&
+		a.increment == b.increment && a.shiftOnWrite == b.shiftOnWrite;
+}
+
+/*!
+	@brief Make one random call, the same for both LCDs with the same generator state
+	@param lcd LCD to call
+	@param random Generator, copied so both LCDs see the same numbers
+	@param name Returns the call made, for the failure report
+*/
+static void randomCall(HD44780LCD &lcd, std::mt19937 random, std::string &name)
+{
+	auto pick = [&random](uint32_t n) {return (uint8_t)(random() % n);};
+	HD44780LCD::LCDDirectionType_e direction = pick(2) ? lcd.LCDMoveRight : lcd.LCDMoveLeft;
+	uint8_t charmap[8];
+	char text[8];
+
+	switch (pick(12))
+	{
+		case 0: case 1:
+			name = "LCDGOTO";
+			lcd.LCDGOTO((HD44780LCD::LCDLineNumber_e)(1 + pick(4)), pick(20));
+		break;
+		case 2: case 3:
+			name = "LCDMoveCursor";
+			lcd.LCDMoveCursor(direction, 1 + pick(5));
+		break;
+		case 4: case 5:
+			name = "LCDScroll";
+			lcd.LCDScroll(direction, 1 + pick(5));
+		break;
+		case 6:
+			name = "LCDDisplayON";
+			lcd.LCDDisplayON(pick(4) != 0);
+		break;
+		case 7:
+			name = "LCDChangeEntryMode";
+			lcd.LCDChangeEntryMode((HD44780LCD::LCDEntryMode_e)(HD44780LCD::LCDEntryModeOne + pick(4)));
+		break;
+		case 8:
+			name = "LCDSendChar";
+			lcd.LCDSendChar('A' + pick(26));
+		break;
+		case 9:
+			name = "LCDSendString";
+			for (uint8_t i = 0; i < 7; i++) {text[i] = 'a' + pick(26);}
+			text[1 + pick(6)] = 0;
+			lcd.LCDSendString(text);
+		break;
+		case 10:
+			name = "LCDCreateCustomChar";
+			for (uint8_t i = 0; i < 8; i++) {charmap[i] = pick(32);}
+			lcd.LCDCreateCustomChar(pick(8), charmap);
+		break;
+		default:
+			switch (pick(3))
+			{
+				case 0: name = "LCDClearScreenCmd"; lcd.LCDClearScreenCmd(); break;
+				case 1: name = "LCDHome"; lcd.LCDHome(); break;
+				default: name = "LCDPrintCustomChar"; lcd.LCDPrintCustomChar(pick(8)); break;
+			}
+		break;
+	}
+}
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780Emulator &direct = hostBus.BusDevice(0x27);
+	HD44780Emulator &deferred = hostBus.BusDevice(0x26);
+	HD44780LCD lcdDirect(0x27, i2c1, 400, 18, 19);
+	HD44780LCD lcdDeferred(0x26, i2c1, 400, 18, 19);
+	lcdDeferred.LCDSharedBusSet(true);
+	HOST_CHECK(lcdDirect.LCDInit(lcdDirect.LCDCursorTypeOff, 4, 20));
+	HOST_CHECK(lcdDeferred.LCDInit(lcdDeferred.LCDCursorTypeOff, 4, 20));
+	lcdDeferred.LCDDeferModeSet(true);
+
+	std::mt19937 random(2022);
+	uint64_t directBytes = 0;
+	uint64_t deferredBytes = 0;
+	uint32_t mismatches = 0;
+	for (uint32_t sequence = 0; sequence < SEQUENCES; sequence++)
+	{
+		std::string calls;
+		for (uint32_t call = 0; call < CALLS; call++)
+		{
+			std::string name;
+			hostBus.BusCountersReset();
+			randomCall(lcdDirect, random, name);
+			directBytes += hostBus.BusCountersGet().bytes;
+			hostBus.BusCountersReset();
+			randomCall(lcdDeferred, random, name);
+			deferredBytes += hostBus.BusCountersGet().bytes;
+			random.discard(64);
+			calls += name + " ";
+		}
+		hostBus.BusCountersReset();
+		lcdDeferred.LCDDeferFlush();
+		deferredBytes += hostBus.BusCountersGet().bytes;
+		if (sameState(direct, deferred) == false)
+		{
+			printf("sequence %u differs: %s\n", (unsigned)sequence, calls.c_str());
+			mismatches++;
+			break;
+		}
+	}
+	HOST_CHECK_EQUAL(mismatches, 0u);
+	HOST_CHECK(deferredBytes < directBytes);
+	printf("bus bytes direct %llu , deferred %llu\n", (unsigned long long)directBytes, (unsigned long long)deferredBytes);
+
+	// commands still queued go out ahead of a row or flush and are in the count returned
+	lcdDeferred.LCDClearScreenCmd();
+	lcdDeferred.LCDChangeEntryMode(lcdDeferred.LCDEntryModeThree);
+	lcdDeferred.LCDGOTO(lcdDeferred.LCDLineNumberTwo, 4);
+	lcdDeferred.LCDDisplayON(true);
+	hostBus.BusCountersReset();
+	uint16_t returned = lcdDeferred.LCDWriteLine(lcdDeferred.LCDLineNumberTwo, "    ab");
+	HOST_CHECK_EQUAL((uint32_t)returned, hostBus.BusCountersGet().bytes);
+	HOST_CHECK_EQUAL(returned, (uint16_t)(4 * (3 + 2))); // display control , entry mode , address , "ab"
+	lcdDeferred.LCDChangeEntryMode(lcdDeferred.LCDEntryModeOne);
+	hostBus.BusCountersReset();
+	returned = lcdDeferred.LCDWriteLine(lcdDeferred.LCDLineNumberTwo, "    abc");
+	HOST_CHECK_EQUAL((uint32_t)returned, hostBus.BusCountersGet().bytes);
+	lcdDeferred.LCDChangeEntryMode(lcdDeferred.LCDEntryModeThree);
+	lcdDeferred.LCDBufferModeSet(true);
+	lcdDeferred.LCDGOTO(lcdDeferred.LCDLineNumberThree, 0);
+	lcdDeferred.print("xyz");
+	lcdDeferred.LCDDisplayON(false);
+	hostBus.BusCountersReset();
+	returned = lcdDeferred.LCDFlush();
+	HOST_CHECK_EQUAL((uint32_t)returned, hostBus.BusCountersGet().bytes);
+	lcdDeferred.LCDBufferModeSet(false);
+	HOST_CHECK_EQUAL(deferred.EmuRowText(2, 4, 20), "    abc             ");
+	HOST_CHECK_EQUAL(deferred.EmuRowText(3, 4, 20), "xyz                 ");
+
+	HOST_CHECK_EQUAL(direct.busyWrites, 0u);
+	HOST_CHECK_EQUAL(deferred.busyWrites, 0u);
+	return HOST_TEST_END();
+}
@@ -0,0 +1,166 @@
+/*!
+	@file     TestEmulator.cpp
+	@author   Gavin Lyons
+	@brief    Host test, the emulator decodes what the library sends and counts the bus cost.
+*/
+
+#include "hd44780/HD44780_LCD_PCF8574_Geometry.hpp"
+#include "hd44780/HD44780_LCD_PCF8574_Marquee.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780LCD lcd(0x27, i2c1, 100, 18, 19);
+	HD44780Emulator &device = hostBus.BusDevice();
+
+	// init leaves the controller in 4 bit mode, 2 lines, display on, clear
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOn, 2, 16));
+	HOST_CHECK(device.eightBit == false);
+	HOST_CHECK_EQUAL(device.functionSet, 0x28);
+	HOST_CHECK_EQUAL(device.displayControl, 0x0E);
+	HOST_CHECK_EQUAL(device.EmuScreenText(2, 16), std::string(16, ' ') + "\n" + std::string(16, ' '));
+
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 0);
+	lcd.LCDSendString((char *)"Hello");
+	lcd.LCDGOTO(lcd.LCDLineNumberTwo, 11);
+	lcd.print(1234);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "Hello           ");
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "           1234 ");
+
+	// one HD44780 byte is 4 port bytes , a 100 KHz byte is 90 uS on the bus
+	hostBus.BusCountersReset();
+	lcd.LCDSendChar('!');
+	HostBusCounters_t counters = hostBus.BusCountersGet();
+	HOST_CHECK_EQUAL(counters.bytes, 4u);
+	HOST_CHECK_EQUAL(counters.transactions, 1u);
+	HOST_CHECK_EQUAL(counters.busTimeNs, 460000ull);
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "           1234!");
+
+	// clear command is one command , clearing with spaces writes every cell
+	hostBus.BusCountersReset();
+	lcd.LCDClearScreenCmd();
+	uint32_t clearCmdBytes = hostBus.BusCountersGet().bytes;
+	lcd.LCDSendString((char *)"x");
+	hostBus.BusCountersReset();
+	lcd.LCDClearScreen();
+	uint32_t clearBytes = hostBus.BusCountersGet().bytes;
+	HOST_CHECK_EQUAL(clearCmdBytes, 4u);
+	HOST_CHECK(clearBytes > 4u * 32u);
+	HOST_CHECK_EQUAL(device.EmuScreenText(2, 16), std::string(16, ' ') + "\n" + std::string(16, ' '));
+
+	// display shift , entry mode and cursor moves are modelled
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 0);
+	lcd.LCDSendString((char *)"ABC");
+	lcd.LCDScroll(lcd.LCDMoveLeft, 1);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "BC              ");
+	lcd.LCDScroll(lcd.LCDMoveRight, 1);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "ABC             ");
+
+	// reads see the address counter through the PCF8574
+	lcd.LCDGOTO(lcd.LCDLineNumberTwo, 3);
+	HOST_CHECK_EQUAL(lcd.LCDReadAddressCounter(), 0x43);
+
+	// number bases , power of two bases use a shift of log2(base)
+	const struct {long value; int base; const char *text;} numbers[] = {
+		{1234567L, 32, "15LK7"}, {1234567L, 16, "12D687"}, {1234567L, 8, "4553207"},
+		{1234567L, 4, "10231122013"}, {45L, 2, "101101"}, {1234567L, 36, "QGLJ"}, {-1234567L, 10, "-1234567"},
+	};
+	for (const auto &number : numbers) {
+		lcd.LCDClearScreenCmd();
+		lcd.print(number.value, number.base);
+		HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), (number.text + std::string(16, ' ')).substr(0, 16));
+	}
+
+	// one encode table for both backlight states , shared by every instance
+	uint8_t encoded[4];
+	lcd.LCDBackLightSet(false);
+	lcd.LCDEncode((const uint8_t *)"A", 1, true, encoded);
+	HOST_CHECK(encoded[0] == 0x45 && encoded[1] == 0x41 && encoded[2] == 0x15 && encoded[3] == 0x11);
+	lcd.LCDClearScreenCmd();
+	lcd.LCDSendChar('A');
+	HOST_CHECK_EQUAL(device.port, 0x11);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "A               ");
+	lcd.LCDBackLightSet(true);
+	lcd.LCDEncode((const uint8_t *)"A", 1, false, encoded);
+	HOST_CHECK(encoded[0] == 0x4C && encoded[1] == 0x48 && encoded[2] == 0x1C && encoded[3] == 0x18);
+
+	// up to 9 digits use fixed point , more take the soft-float path as before
+	lcd.LCDClearScreenCmd();
+	lcd.print(-2.5, 9);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "-2.500000000    ");
+	lcd.LCDClearScreenCmd();
+	lcd.print(1.999, 2);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "2.00            ");
+	lcd.LCDClearScreenCmd();
+	lcd.print(2.5, 12);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "2.500000000000  ");
+
+	HOST_CHECK_EQUAL(device.busyWrites, 0u);
+
+	// changed runs , one unchanged cell between two changes is sent again
+	lcd.LCDClearScreen();
+	lcd.LCDWriteLine(lcd.LCDLineNumberOne, "abcdefgh");
+	HOST_CHECK_EQUAL(lcd.LCDWriteLine(lcd.LCDLineNumberOne, "aXcXefgh"), 4u * (1 + 3));
+	HOST_CHECK_EQUAL(lcd.LCDWriteLine(lcd.LCDLineNumberOne, "QXcXeYgh"), 4u * (1 + 1) * 2);
+	HOST_CHECK_EQUAL(lcd.LCDWriteLine(lcd.LCDLineNumberOne, "QXcXeYgh"), 0u);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "QXcXeYgh        ");
+	// cursor is at the change but the counter is in CGRAM , the address going back is counted
+	uint8_t bar[8] = {0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F};
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 6);
+	lcd.LCDCreateCustomChar(1, bar);
+	hostBus.BusCountersReset();
+	HOST_CHECK_EQUAL(lcd.LCDWriteLine(lcd.LCDLineNumberOne, "QXcXeYZh"), 4u * (1 + 1));
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().bytes, 4u * (1 + 1));
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "QXcXeYZh        ");
+
+	// marquee window uses the same runs , each step is one address command and the changed cells
+	HD44780LCDMarquee marquee(lcd);
+	HOST_CHECK(marquee.LCDMarqueeBegin("0123456789", lcd.LCDLineNumberTwo, 4, 6, 1000));
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "    012345      ");
+	marquee.LCDMarqueeTick(1);
+	hostBus.BusCountersReset();
+	HOST_CHECK(marquee.LCDMarqueeTick(1001));
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().bytes, 4u * (1 + 6));
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "    123456      ");
+	HOST_CHECK(marquee.LCDMarqueeBegin("aabaab", lcd.LCDLineNumberTwo, 4, 3, 1000));
+	marquee.LCDMarqueeTick(1);
+	hostBus.BusCountersReset();
+	HOST_CHECK(marquee.LCDMarqueeTick(1001)); // aab to aba , cells 1 and 2 change
+	HOST_CHECK_EQUAL(hostBus.BusCountersGet().bytes, 4u * (1 + 2));
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "    aba456      ");
+	marquee.LCDMarqueeStop();
+
+	// compile time size , runtime positions off the LCD are ignored like the base class
+	HD44780Emulator &small = hostBus.BusDevice(0x26);
+	HD44780LCDGeometry<2, 16> geometry(0x26, i2c1, 100, 18, 19);
+	HOST_CHECK(geometry.LCDInit(geometry.LCDCursorTypeOff));
+	geometry.LCDGOTO<HD44780LCD::LCDLineNumberTwo, 4>();
+	geometry.LCDSendChar('G');
+	geometry.LCDGOTO(HD44780LCD::LCDLineNumberOne, 2);
+	geometry.LCDSendChar('g');
+	uint32_t commands = small.commands;
+	geometry.LCDGOTO(HD44780LCD::LCDLineNumberThree, 0);
+	geometry.LCDGOTO((HD44780LCD::LCDLineNumber_e)0, 0);
+	HOST_CHECK_EQUAL(small.commands, commands);
+	geometry.LCDSendChar('h');
+	HOST_CHECK_EQUAL(small.EmuScreenText(2, 16), "  gh            \n    G           ");
+	HOST_CHECK_EQUAL(small.busyWrites, 0u);
+
+	// columns past the edge stay in the row's DDRAM for LCDScroll , only the 16x01 splits
+	geometry.LCDGOTO(HD44780LCD::LCDLineNumberOne, 16);
+	geometry.LCDSendChar('x');
+	geometry.LCDGOTO(HD44780LCD::LCDLineNumberTwo, 16);
+	geometry.LCDSendChar('y');
+	HOST_CHECK_EQUAL(small.ddram[0x10], (uint8_t)'x');
+	HOST_CHECK_EQUAL(small.ddram[0x50], (uint8_t)'y');
+	HOST_CHECK_EQUAL(small.EmuScreenText(2, 16), "  gh            \n    G           ");
+	HOST_CHECK_EQUAL(HD44780LCD::LCDCellAddress(2, 16, 2, 16), (uint8_t)0x50);
+
+	// a missing device is not acknowledged
+	hostBus.BusDeviceRemove(0x27);
+	HD44780LCD absent(0x27, i2c1, 100, 18, 19);
+	HOST_CHECK(absent.LCDInit(absent.LCDCursorTypeOn, 2, 16) == false);
+	return HOST_TEST_END();
+}
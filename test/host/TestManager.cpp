@@ -0,0 +1,109 @@
+/*!
+	@file     TestManager.cpp
+	@author   Gavin Lyons
+	@brief    Host test, three displays on one bus share each frame round robin within the byte budget.
+	@details Display 0 changes every frame and alone uses the whole budget, the others must still
+		be served in turn. The frame rate is checked on the simulated clock.
+*/
+
+#include <string.h>
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+#include "hd44780/HD44780_LCD_PCF8574_Manager.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+#define ROW_BYTES (4 * (1 + 16)) // address and 16 characters
+#define ONE_ROW_BUDGET (ROW_BYTES + 3) // a row with or without its address , too little left for another
+
+/*! Run one frame and check the count returned is what went on the bus */
+static uint16_t frame(HD44780LCDManager &manager, uint16_t budget)
+{
+	hostBus.BusCountersReset();
+	uint16_t bytes = manager.LCDManagerFrame(budget);
+	HOST_CHECK_EQUAL((uint32_t)bytes, hostBus.BusCountersGet().bytes);
+	HOST_CHECK(bytes <= budget);
+	return bytes;
+}
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780Emulator *devices[3] = {&hostBus.BusDevice(0x25), &hostBus.BusDevice(0x26), &hostBus.BusDevice(0x27)};
+	HD44780LCD lcd0(0x25, i2c1, 400, 18, 19);
+	HD44780LCD lcd1(0x26, i2c1, 400, 18, 19);
+	HD44780LCD lcd2(0x27, i2c1, 400, 18, 19);
+	HD44780LCD *displays[3] = {&lcd0, &lcd1, &lcd2};
+	HD44780LCDManager manager(i2c1, 400, 18, 19);
+
+	HOST_CHECK(manager.LCDManagerBegin());
+	for (uint8_t index = 0; index < 3; index++) {
+		HOST_CHECK_EQUAL(manager.LCDManagerAdd(*displays[index]), (int8_t)index);
+		HOST_CHECK(displays[index]->LCDInit(displays[index]->LCDCursorTypeOff, 2, 16));
+		displays[index]->LCDClearScreen();
+		while (displays[index]->LCDBufferDirtyGet()) {displays[index]->LCDFlush();}
+	}
+	HOST_CHECK_EQUAL(manager.LCDManagerCountGet(), (uint8_t)3);
+	HOST_CHECK(manager.LCDManagerDisplayGet(3) == nullptr);
+
+	// nothing to send , the next frame starts one on at display 1
+	HOST_CHECK_EQUAL(frame(manager, 1000), (uint16_t)0);
+	HOST_CHECK_EQUAL(manager.LCDManagerFramesGet(), 0u);
+
+	// display 0 is rewritten every frame and fills the budget , 1 and 2 still get their turn
+	char text[17] = {};
+	lcd1.LCDGOTO(lcd1.LCDLineNumberOne, 0);
+	lcd1.print("display_one_0123");
+	lcd2.LCDGOTO(lcd2.LCDLineNumberOne, 0);
+	lcd2.print("display_two_0123");
+	for (uint8_t step = 0; step < 3; step++)
+	{
+		memset(text, 'A' + step, 16); // every cell changes
+		lcd0.LCDGOTO(lcd0.LCDLineNumberOne, 0);
+		lcd0.print(text);
+		HOST_CHECK(frame(manager, ONE_ROW_BUDGET) >= ROW_BYTES - 4);
+	}
+	// frame 0 display 1 , frame 1 display 2 , frame 2 display 0 with its latest text
+	HOST_CHECK_EQUAL(devices[0]->EmuRowText(1, 2, 16), "CCCCCCCCCCCCCCCC");
+	HOST_CHECK_EQUAL(devices[1]->EmuRowText(1, 2, 16), "display_one_0123");
+	HOST_CHECK_EQUAL(devices[2]->EmuRowText(1, 2, 16), "display_two_0123");
+	HOST_CHECK_EQUAL(manager.LCDManagerFramesGet(0), 1u);
+	HOST_CHECK_EQUAL(manager.LCDManagerFramesGet(1), 1u);
+	HOST_CHECK_EQUAL(manager.LCDManagerFramesGet(2), 1u);
+	HOST_CHECK(lcd0.LCDBufferDirtyGet() == false);
+
+	// a display cut short by the budget is finished after the next one is served
+	lcd1.LCDGOTO(lcd1.LCDLineNumberTwo, 0);
+	lcd1.print("one_second_row_1");
+	lcd2.LCDGOTO(lcd2.LCDLineNumberTwo, 0);
+	lcd2.print("two_second_row_2");
+	HOST_CHECK(frame(manager, ROW_BYTES / 2) > 0);
+	HOST_CHECK(lcd1.LCDBufferDirtyGet() == true);
+	HOST_CHECK(lcd2.LCDBufferDirtyGet() == true);
+	HOST_CHECK(frame(manager, ONE_ROW_BUDGET) >= ROW_BYTES - 4);
+	HOST_CHECK(lcd2.LCDBufferDirtyGet() == false);
+	HOST_CHECK(lcd1.LCDBufferDirtyGet() == true);
+	HOST_CHECK(frame(manager, ONE_ROW_BUDGET) > 0);
+	HOST_CHECK(lcd1.LCDBufferDirtyGet() == false);
+	HOST_CHECK_EQUAL(devices[1]->EmuRowText(2, 2, 16), "one_second_row_1");
+	HOST_CHECK_EQUAL(devices[2]->EmuRowText(2, 2, 16), "two_second_row_2");
+
+	// a budget below one address and character sends nothing
+	lcd0.LCDGOTO(lcd0.LCDLineNumberTwo, 0);
+	lcd0.print('x');
+	HOST_CHECK_EQUAL(frame(manager, 7), (uint16_t)0);
+	HOST_CHECK(lcd0.LCDBufferDirtyGet() == true);
+
+	// frame rate , one display frame every 100 mS of the simulated clock
+	while (lcd0.LCDBufferDirtyGet()) {frame(manager, 1000);}
+	for (uint8_t step = 0; step < 25; step++)
+	{
+		hostBus.BusAdvanceUs(100000);
+		lcd0.LCDGOTO(lcd0.LCDLineNumberTwo, 0);
+		lcd0.print((step & 1) ? 'a' : 'b');
+		frame(manager, 1000);
+	}
+	HOST_CHECK(manager.LCDManagerFPSGet() >= 9 && manager.LCDManagerFPSGet() <= 10);
+	HOST_CHECK_EQUAL(devices[0]->busyWrites + devices[1]->busyWrites + devices[2]->busyWrites, 0u);
+
+	return HOST_TEST_END();
+}
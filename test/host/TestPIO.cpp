@@ -0,0 +1,154 @@
+/*!
+	@file     TestPIO.cpp
+	@author   Gavin Lyons
+	@brief    Host test, the PIO I2C master run bit by bit on the simulated PIO, START, STOP and NACK paths.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <regex>
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+#include "HD44780_LCD_PCF8574_I2C.pio.h"
+#include "HD44780_HostPIO.hpp"
+#include "HostTest.hpp"
+
+/*!
+	@brief Check the instruction words of the stand in header against the .pio source
+	@details Opcode, operand, delay and side set of each line, and the wrap points.
+*/
+static void checkProgram(void)
+{
+	std::ifstream source(HD44780_PIO_SOURCE);
+	HOST_CHECK(source.is_open());
+	const char *opcodes[8] = {"jmp", "wait", "in", "out", "pull", "mov", "irq", "set"};
+	std::regex delay("\\[(\\d+)\\]");
+	std::regex side("side (\\d)");
+	std::regex operand("^\\w+\\s+\\w+,\\s*(\\d+)");
+	std::smatch match;
+	std::string line;
+	int count = 0, wrapTarget = -1, wrap = -1;
+
+	while (std::getline(source, line))
+	{
+		if (line.rfind("% c-sdk", 0) == 0) {break;}
+		line = line.substr(0, line.find(';'));
+		line = std::regex_replace(line, std::regex("^\\s+|\\s+$"), "");
+		if (line.empty() || line.back() == ':' || line == ".program hd44780_i2c" || line.rfind(".side_set", 0) == 0) {continue;}
+		if (line == ".wrap_target") {wrapTarget = count; continue;}
+		if (line == ".wrap") {wrap = count - 1; continue;}
+		if (count >= hd44780_i2c_program.length) {count++; continue;}
+
+		uint16_t word = hd44780_i2c_program.instructions[count];
+		std::string mnemonic = line.substr(0, line.find_first_of(" \t"));
+		if (mnemonic == "nop") {mnemonic = "mov";}
+		if (mnemonic != opcodes[word >> 13]) {printf("  %d: %s\n", count, line.c_str());}
+		HOST_CHECK_EQUAL(mnemonic, std::string(opcodes[word >> 13]));
+		int expectDelay = std::regex_search(line, match, delay) ? std::stoi(match[1]) : 0;
+		HOST_CHECK_EQUAL((word >> 8) & 0x07, expectDelay);
+		bool hasSide = std::regex_search(line, match, side);
+		HOST_CHECK_EQUAL((bool)(word & 0x1000), hasSide);
+		if (hasSide == true) {HOST_CHECK_EQUAL((word >> 11) & 0x01, std::stoi(match[1]));}
+		if ((mnemonic == "set" || mnemonic == "out") && std::regex_search(line, match, operand)) {
+			HOST_CHECK_EQUAL(word & 0x1F, std::stoi(match[1]));
+		}
+		count++;
+	}
+	HOST_CHECK_EQUAL(count, (int)hd44780_i2c_program.length);
+	HOST_CHECK_EQUAL(wrapTarget, hd44780_i2c_wrap_target);
+	HOST_CHECK_EQUAL(wrap, hd44780_i2c_wrap);
+}
+
+int main()
+{
+	checkProgram();
+
+	hostBus.BusReset();
+	HD44780Emulator &device = hostBus.BusDevice();
+	hostPIO.PIOLogSet(true);
+
+	// connection check at init , one port byte with enable high between START and STOP
+	HD44780LCD lcd(0x27, pio0, 0, 100, 18, 19);
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOff, 2, 16));
+	HOST_CHECK(lcd.LCDPIOModeGet());
+	HOST_CHECK(pio_sm_is_claimed(pio0, 0));
+	HOST_CHECK(pio_can_add_program(pio0, &hd44780_i2c_program) == false);
+	HOST_CHECK(dma_channel_is_claimed(0));
+	HOST_CHECK_EQUAL(hostPIO.PIOLogGet().substr(0, 8), "S4E+04+P");
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 0);
+	lcd.LCDSendString("PIO");
+	hostBus.BusAdvanceUs(2000); // writes return once DMA has the words
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "PIO             ");
+
+	// one character , address and four port bytes each acknowledged , then STOP
+	lcd.LCDSendChar('A');
+	hostBus.BusAdvanceUs(1000);
+	hostPIO.PIOLogClear();
+	hostBus.BusCountersReset();
+	uint64_t cycles = hostPIO.PIOCyclesGet(pio0, 0);
+	lcd.LCDSendChar('B');
+	hostBus.BusAdvanceUs(1000);
+	HOST_CHECK_EQUAL(hostPIO.PIOLogGet(), "S4E+4D+49+2D+29+P");
+	HostBusCounters_t counters = hostBus.BusCountersGet();
+	HOST_CHECK_EQUAL(counters.transactions, 1u);
+	HOST_CHECK_EQUAL(counters.bytes, 4u);
+	// 5 bytes of 9 SCL periods and the START and STOP, 10 uS a period
+	HOST_CHECK(counters.busTimeNs > 455000 && counters.busTimeNs < 480000);
+	HOST_CHECK(hostPIO.PIOCyclesGet(pio0, 0) - cycles > 5 * 9 * 32);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "PIOAB           ");
+
+	// NACK , STOP is sent , the state machine waits on its IRQ until the next write clears it
+	HD44780LCD::LCDStats_t stats;
+	lcd.LCDStatsReset();
+	hostPIO.PIOLogClear();
+	hostBus.faultNacks = 1;
+	lcd.LCDSendChar('C');
+	hostBus.BusAdvanceUs(1000);
+	HOST_CHECK_EQUAL(hostPIO.PIOLogGet(), "S4E-P");
+	HOST_CHECK(pio_interrupt_get(pio0, 0));
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "PIOAB           ");
+	lcd.LCDSendChar('D');
+	lcd.LCDWaitIdle();
+	HOST_CHECK(pio_interrupt_get(pio0, 0) == false);
+	HOST_CHECK(lcd.LCDRecoverPendingGet() == false);
+	lcd.LCDStatsGet(stats);
+	HOST_CHECK_EQUAL(stats.nacks, 1u);
+	HOST_CHECK_EQUAL(stats.recoveries, 1u);
+	hostBus.BusAdvanceUs(1000);
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "PIOABCD         ");
+	std::string log = hostPIO.PIOLogGet();
+	HOST_CHECK(log.find("S4E-P") == 0);
+	HOST_CHECK(log.find("-", 5) == std::string::npos);
+
+	// the destructor hands back the state machine , program and DMA channel
+	{
+		HD44780LCD second(0x26, pio1, 2, 400, 20, 21);
+		hostBus.BusDevice(0x26);
+		HOST_CHECK(second.LCDInit(second.LCDCursorTypeOff, 2, 16));
+		HOST_CHECK(pio_sm_is_claimed(pio1, 2));
+		HOST_CHECK(dma_channel_is_claimed(1));
+	}
+	HOST_CHECK(pio_sm_is_claimed(pio1, 2) == false);
+	HOST_CHECK(pio_can_add_program(pio1, &hd44780_i2c_program));
+	HOST_CHECK(dma_channel_is_claimed(1) == false);
+
+	// wrong pins or no device
+	HD44780LCD badPins(0x27, pio1, 0, 100, 19, 18);
+	HOST_CHECK(badPins.LCDInit(badPins.LCDCursorTypeOff, 2, 16) == false);
+	HD44780LCD absent(0x20, pio1, 0, 100, 20, 21);
+	HOST_CHECK(absent.LCDInit(absent.LCDCursorTypeOff, 2, 16) == false);
+	HOST_CHECK(pio_sm_is_claimed(pio1, 0) == false);
+
+	// a state machine claimed by other code is left alone , no panic
+	pio_sm_claim(pio1, 3);
+	{
+		HD44780LCD taken(0x26, pio1, 3, 400, 20, 21);
+		HOST_CHECK(taken.LCDInit(taken.LCDCursorTypeOff, 2, 16) == false);
+		HOST_CHECK(pio_can_add_program(pio1, &hd44780_i2c_program));
+	}
+	HOST_CHECK(pio_sm_is_claimed(pio1, 3));
+	pio_sm_unclaim(pio1, 3);
+
+	HOST_CHECK_EQUAL(device.busyWrites, 0u);
+	return HOST_TEST_END();
+}
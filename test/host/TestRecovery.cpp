@@ -0,0 +1,101 @@
+/*!
+	@file     TestRecovery.cpp
+	@author   Gavin Lyons
+	@brief    Host test, I2C faults are injected and the LCD must be resynced and restored.
+*/
+
+#include <string.h>
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+static uint8_t heart[8] = {0x00, 0x0A, 0x1F, 0x1F, 0x0E, 0x04, 0x00, 0x00};
+
+/*! Check the whole visible state of the controller against what was written */
+static void checkScreen(HD44780Emulator &device, const char *row1, const char *row2, int line)
+{
+	if (device.EmuRowText(1, 2, 16) != row1 || device.EmuRowText(2, 2, 16) != row2) {
+		printf("screen check from line %d\n", line);
+	}
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), row1);
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), row2);
+	HOST_CHECK(memcmp(device.cgram, heart, 8) == 0);
+	HOST_CHECK(device.eightBit == false);
+	HOST_CHECK_EQUAL(device.displayControl, (uint8_t)0x0C);
+}
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780Emulator &device = hostBus.BusDevice();
+	HD44780LCD lcd(0x27, i2c1, 100, 18, 19);
+	HD44780LCD::LCDStats_t stats;
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOff, 2, 16));
+	lcd.LCDCreateCustomChar(0, heart);
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 0);
+	lcd.LCDSendString("Hello");
+	lcd.LCDGOTO(lcd.LCDLineNumberTwo, 0);
+	lcd.LCDSendString("World");
+	checkScreen(device, "Hello           ", "World           ", __LINE__);
+	lcd.LCDStatsReset();
+
+	// two NACKs , the third attempt gets through and the controller is resynced
+	hostBus.faultNacks = 2;
+	lcd.LCDSendChar('!');
+	HOST_CHECK(lcd.LCDRecoverPendingGet() == false);
+	lcd.LCDStatsGet(stats);
+	HOST_CHECK_EQUAL(stats.retries, 2u);
+	HOST_CHECK_EQUAL(stats.nacks, 2u);
+	HOST_CHECK_EQUAL(stats.recoveries, 1u);
+	checkScreen(device, "Hello           ", "World!          ", __LINE__);
+
+	// timeout after the first nibble leaves the controller half way through a byte
+	lcd.LCDStatsReset();
+	hostBus.faultTimeoutAfter = 2;
+	lcd.LCDSendChar('?');
+	HOST_CHECK(lcd.LCDRecoverPendingGet() == false);
+	lcd.LCDStatsGet(stats);
+	HOST_CHECK_EQUAL(stats.timeouts, 1u);
+	HOST_CHECK_EQUAL(stats.recoveries, 1u);
+	checkScreen(device, "Hello           ", "World!?         ", __LINE__);
+
+	// a slave holding SDA is clocked free before the last attempt
+	lcd.LCDStatsReset();
+	hostBus.faultSDAStuck = 5;
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 5);
+	lcd.LCDPrintCustomChar(0);
+	HOST_CHECK_EQUAL(hostBus.faultSDAStuck, (uint8_t)0);
+	HOST_CHECK(lcd.LCDRecoverPendingGet() == false);
+	lcd.LCDStatsGet(stats);
+	HOST_CHECK_EQUAL(stats.retries, 2u);
+	HOST_CHECK_EQUAL(stats.recoveries, 1u);
+	checkScreen(device, "Hello#          ", "World!?         ", __LINE__);
+	HOST_CHECK_EQUAL(device.ddram[5], (uint8_t)0);
+
+	// bus down , writes are kept in the shadow and replayed once it is back
+	lcd.LCDStatsReset();
+	device.present = false;
+	lcd.LCDGOTO(lcd.LCDLineNumberTwo, 10);
+	lcd.LCDSendString("lost");
+	HOST_CHECK(lcd.LCDRecoverPendingGet());
+	device.present = true;
+	memset(device.ddram, '*', sizeof(device.ddram)); // controller lost everything
+	memset(device.cgram, 0, sizeof(device.cgram));
+	uint64_t startNs = hostBus.BusNowNs();
+	lcd.LCDSendChar('s');
+	uint64_t recoveryNs = hostBus.BusNowNs() - startNs;
+	HOST_CHECK(lcd.LCDRecoverPendingGet() == false);
+	lcd.LCDStatsGet(stats);
+	HOST_CHECK_EQUAL(stats.recoveries, 1u);
+	HOST_CHECK(stats.recoveryTime > 0u);
+	HOST_CHECK(stats.recoveryTime * 1000ull <= recoveryNs);
+	checkScreen(device, "Hello#          ", "World!?   losts ", __LINE__);
+	printf("restore after bus down : %.1f mS\n", recoveryNs / 1e6);
+
+	// the address counter is back where the last write left it
+	lcd.LCDSendChar('.');
+	checkScreen(device, "Hello#          ", "World!?   losts.", __LINE__);
+
+	HOST_CHECK_EQUAL(device.busyWrites, 0u);
+	return HOST_TEST_END();
+}
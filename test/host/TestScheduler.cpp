@@ -0,0 +1,103 @@
+/*!
+	@file     TestScheduler.cpp
+	@author   Gavin Lyons
+	@brief    Host test, scheduler regions go out by priority, rate limit and byte budget, latest text wins.
+	@details Every tick checks the bytes it reports against the bytes seen on the bus.
+*/
+
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+#include "hd44780/HD44780_LCD_PCF8574_Scheduler.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+static uint8_t heart[8] = {0x00, 0x0A, 0x1F, 0x1F, 0x0E, 0x04, 0x00, 0x00};
+
+/*! Tick and check the count returned is what went on the bus */
+static uint16_t tick(HD44780LCDScheduler &scheduler, uint64_t nowUs, uint16_t budget)
+{
+	hostBus.BusCountersReset();
+	uint16_t bytes = scheduler.LCDSchedulerTick(nowUs, budget);
+	HOST_CHECK_EQUAL((uint32_t)bytes, hostBus.BusCountersGet().bytes);
+	HOST_CHECK(bytes <= budget);
+	return bytes;
+}
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780Emulator &device = hostBus.BusDevice();
+	HD44780LCD lcd(0x27, i2c1, 100, 18, 19);
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOff, 2, 16));
+	lcd.LCDClearScreen();
+	HD44780LCDScheduler scheduler(lcd);
+
+	int8_t low = scheduler.LCDSchedulerAdd(lcd.LCDLineNumberOne, 0, 4, 0, 1);
+	int8_t high = scheduler.LCDSchedulerAdd(lcd.LCDLineNumberTwo, 0, 4, 0, 5);
+	int8_t limited = scheduler.LCDSchedulerAdd(lcd.LCDLineNumberOne, 8, 4, 100000, 9);
+	int8_t glyph = scheduler.LCDSchedulerAdd(lcd.LCDLineNumberTwo, 10, 2, 0, 1);
+	HOST_CHECK(low == 0 && high == 1 && limited == 2 && glyph == 3);
+	HOST_CHECK_EQUAL(scheduler.LCDSchedulerAdd(lcd.LCDLineNumberOne, 14, 4, 0, 1), (int8_t)-1);
+	HOST_CHECK_EQUAL(scheduler.LCDSchedulerAdd(lcd.LCDLineNumberThree, 0, 4, 0, 1), (int8_t)-1);
+	HOST_CHECK_EQUAL(scheduler.LCDSchedulerCountGet(), (uint8_t)4);
+
+	// priority , the budget holds one region of address + 4 characters
+	scheduler.LCDSchedulerWrite(low, "AAAA");
+	scheduler.LCDSchedulerWrite(high, "BBBB");
+	HOST_CHECK_EQUAL(tick(scheduler, 1000, 20), (uint16_t)20);
+	HOST_CHECK_EQUAL(device.EmuScreenText(2, 16), "                \nBBBB            ");
+	HOST_CHECK(scheduler.LCDSchedulerDirtyGet(low) == true);
+	HOST_CHECK(scheduler.LCDSchedulerDirtyGet(high) == false);
+	HOST_CHECK_EQUAL(tick(scheduler, 2000, 100), (uint16_t)20);
+	HOST_CHECK_EQUAL(device.EmuScreenText(2, 16), "AAAA            \nBBBB            ");
+	HOST_CHECK_EQUAL(tick(scheduler, 3000, 100), (uint16_t)0);
+
+	// latest value wins , only the last text is sent and only the changed span
+	scheduler.LCDSchedulerWrite(low, "1111");
+	scheduler.LCDSchedulerWrite(low, "A22A");
+	HOST_CHECK_EQUAL(tick(scheduler, 4000, 100), (uint16_t)(4 * (1 + 2)));
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "A22A            ");
+	scheduler.LCDSchedulerWrite(low, "zzzz");
+	scheduler.LCDSchedulerWrite(low, "A22A");
+	HOST_CHECK(scheduler.LCDSchedulerDirtyGet(low) == false);
+
+	// a waiting low priority region ages past a newer high priority one
+	scheduler.LCDSchedulerWrite(low, "CCCC");
+	tick(scheduler, 500000, 0);
+	scheduler.LCDSchedulerWrite(high, "DDDD");
+	HOST_CHECK_EQUAL(tick(scheduler, 500000, 20), (uint16_t)20);
+	HOST_CHECK_EQUAL(device.EmuScreenText(2, 16), "CCCC            \nBBBB            ");
+	HOST_CHECK_EQUAL(tick(scheduler, 510000, 100), (uint16_t)20);
+
+	// rate limit , the first refresh goes at once , the next waits for the interval
+	scheduler.LCDSchedulerWrite(limited, "x");
+	HOST_CHECK_EQUAL(tick(scheduler, 600000, 100), (uint16_t)(4 * (1 + 1)));
+	scheduler.LCDSchedulerWrite(limited, "y");
+	HOST_CHECK_EQUAL(tick(scheduler, 650000, 100), (uint16_t)0);
+	HOST_CHECK(scheduler.LCDSchedulerDirtyGet(limited) == true);
+	HOST_CHECK_EQUAL(tick(scheduler, 700000, 100), (uint16_t)(4 * (1 + 1)));
+	HOST_CHECK_EQUAL(device.EmuRowText(1, 2, 16), "CCCC    y       ");
+
+	// byte budget , a region cut short carries on where the cursor already is
+	scheduler.LCDSchedulerWrite(high, "EFGH");
+	HOST_CHECK_EQUAL(tick(scheduler, 800000, 7), (uint16_t)0);
+	HOST_CHECK_EQUAL(tick(scheduler, 800000, 12), (uint16_t)(4 * (1 + 2)));
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "EFDD            ");
+	HOST_CHECK(scheduler.LCDSchedulerDirtyGet(high) == true);
+	HOST_CHECK_EQUAL(tick(scheduler, 800001, 12), (uint16_t)(4 * 2));
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "EFGH            ");
+	HOST_CHECK(scheduler.LCDSchedulerDirtyGet(high) == false);
+
+	// the cursor is there but the counter is in CGRAM , the address is sent and counted
+	scheduler.LCDSchedulerWrite(glyph, "ab");
+	HOST_CHECK_EQUAL(tick(scheduler, 900000, 100), (uint16_t)(4 * (1 + 2)));
+	scheduler.LCDSchedulerWrite(glyph, "abc");
+	scheduler.LCDSchedulerWrite(glyph, "ab");
+	lcd.LCDGOTO(lcd.LCDLineNumberTwo, 10);
+	lcd.LCDCreateCustomChar(0, heart);
+	scheduler.LCDSchedulerWrite(glyph, "Zb");
+	HOST_CHECK_EQUAL(tick(scheduler, 900001, 100), (uint16_t)(4 * (1 + 1)));
+	HOST_CHECK_EQUAL(device.EmuRowText(2, 2, 16), "EFGH      Zb    ");
+	HOST_CHECK_EQUAL(device.busyWrites, 0u);
+
+	return HOST_TEST_END();
+}
@@ -0,0 +1,132 @@
+/*!
+	@file     TestServiceRing.cpp
+	@author   Gavin Lyons
+	@brief    Host test, the display service ring under a producer and a consumer thread.
+	@details The producer pushes numbered text commands as fast as it can, the consumer
+		performs them on the LCD. Every command that comes out must be whole and in order,
+		and every pushed command is either performed or counted as dropped.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "hd44780/HD44780_LCD_PCF8574_Service.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+#define RING_COMMANDS 20000
+
+/*! LCD that checks each text command it is given before sending it */
+class CheckedLCD : public HD44780LCD {
+	public:
+		CheckedLCD() : HD44780LCD(0x27, i2c1, 400, 18, 19) {}
+
+		size_t write(const uint8_t *buffer, size_t size) override
+		{
+			char text[24] = {0};
+			memcpy(text, buffer, size < 20 ? size : 20);
+			unsigned number = 0;
+			if (size < 8 || sscanf(text, "%08u", &number) != 1) {
+				torn++;
+			} else {
+				// 8 digits then number % 11 copies of one letter
+				bool whole = (size == 8 + number % 11);
+				for (size_t i = 8; i < size; i++) {
+					whole &= (buffer[i] == 'a' + number % 26);
+				}
+				if (whole == false) {torn++;}
+				if (performed > 0 && number <= last) {outOfOrder++;}
+				last = number;
+			}
+			performed++;
+			characters += size;
+			return HD44780LCD::write(buffer, size);
+		}
+
+		uint32_t performed = 0;
+		uint32_t torn = 0;
+		uint32_t outOfOrder = 0;
+		uint32_t characters = 0;
+		unsigned last = 0;
+};
+
+/*! Text for command number, see CheckedLCD::write */
+static void ringText(char *text, unsigned number)
+{
+	snprintf(text, 9, "%08u", number);
+	memset(text + 8, 'a' + number % 26, number % 11);
+	text[8 + number % 11] = 0;
+}
+
+/*!
+	@brief Run one producer and one consumer thread over the ring
+	@param lcd LCD the consumer writes to
+	@param overflow Ring overflow policy
+	@param accepted Returns the commands the ring accepted
+	@param dropped Returns the commands the ring lost or refused
+*/
+static void ringStress(CheckedLCD &lcd, HD44780LCDService::LCDServiceOverflow_e overflow,
+	uint32_t &accepted, uint32_t &dropped)
+{
+	HD44780LCDService service(lcd, overflow);
+	std::atomic<bool> producerDone{false};
+	accepted = 0;
+
+	std::thread consumer([&]() {
+		while (true)
+		{
+			bool done = producerDone.load(std::memory_order_acquire);
+			if (service.LCDServiceProcess() == false && done == true) {break;}
+		}
+	});
+	std::thread producer([&]() {
+		char text[24];
+		for (unsigned number = 0; number < RING_COMMANDS; number++)
+		{
+			ringText(text, number);
+			if (service.LCDServiceText(text)) {accepted++;}
+			// bursts longer than the ring , then room for the consumer to catch up
+			if (number % 64 == 63) {std::this_thread::yield();}
+		}
+		producerDone.store(true, std::memory_order_release);
+	});
+	producer.join();
+	consumer.join();
+	dropped = service.LCDServiceDroppedGet();
+}
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780Emulator &device = hostBus.BusDevice();
+	CheckedLCD lcd;
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOff, 2, 16));
+	device.characters = 0;
+	uint32_t accepted, dropped;
+
+	// drop oldest , the producer never fails and the consumer skips what it lost
+	ringStress(lcd, HD44780LCDService::LCDServiceDropOldest, accepted, dropped);
+	HOST_CHECK_EQUAL(accepted, (uint32_t)RING_COMMANDS);
+	HOST_CHECK_EQUAL(lcd.performed + dropped, (uint32_t)RING_COMMANDS);
+	HOST_CHECK_EQUAL(lcd.torn, 0u);
+	HOST_CHECK_EQUAL(lcd.outOfOrder, 0u);
+	HOST_CHECK_EQUAL(lcd.last, (unsigned)RING_COMMANDS - 1);
+	printf("drop oldest : performed %u dropped %u\n", (unsigned)lcd.performed, (unsigned)dropped);
+
+	// drop newest , everything accepted is performed
+	lcd.performed = 0;
+	ringStress(lcd, HD44780LCDService::LCDServiceDropNewest, accepted, dropped);
+	HOST_CHECK_EQUAL(lcd.performed, accepted);
+	HOST_CHECK_EQUAL(accepted + dropped, (uint32_t)RING_COMMANDS);
+	HOST_CHECK_EQUAL(lcd.torn, 0u);
+	HOST_CHECK_EQUAL(lcd.outOfOrder, 0u);
+	printf("drop newest : performed %u dropped %u\n", (unsigned)lcd.performed, (unsigned)dropped);
+
+	// every performed character reached the controller
+	HOST_CHECK_EQUAL(device.characters, lcd.characters);
+
+	HOST_CHECK_EQUAL(device.busyWrites, 0u);
+	return HOST_TEST_END();
+}
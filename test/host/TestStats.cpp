@@ -0,0 +1,63 @@
+/*!
+	@file     TestStats.cpp
+	@author   Gavin Lyons
+	@brief    Host test, bus counters read from a second core while the first one sends.
+	@details Each blocking write adds to the transaction count and one latency bucket
+		under the same lock, a snapshot taken halfway through an update shows them apart.
+*/
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+#define STATS_WRITES 5000
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780Emulator &device = hostBus.BusDevice();
+	HD44780LCD lcd(0x27, i2c1, 400, 18, 19);
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOff, 2, 16));
+	lcd.LCDStatsReset();
+
+	std::atomic<bool> sending{true};
+	uint32_t snapshots = 0, torn = 0, backwards = 0;
+
+	std::thread core0([&]() {
+		HD44780LCD::LCDStats_t stats;
+		uint32_t last = 0;
+		while (sending.load(std::memory_order_acquire))
+		{
+			lcd.LCDStatsGet(stats);
+			uint32_t bucketSum = 0;
+			for (uint8_t i = 0; i < lcd.LCDStatsBuckets; i++) {bucketSum += stats.latency[i];}
+			if (bucketSum != stats.transactions || stats.bytes % 4 != 0) {torn++;}
+			if (stats.transactions < last) {backwards++;}
+			last = stats.transactions;
+			snapshots++;
+		}
+	});
+	std::thread core1([&]() {
+		for (uint32_t i = 0; i < STATS_WRITES; i++) {
+			lcd.LCDSendChar('a' + i % 26);
+		}
+		sending.store(false, std::memory_order_release);
+	});
+	core1.join();
+	core0.join();
+
+	HD44780LCD::LCDStats_t stats;
+	HOST_CHECK(lcd.LCDStatsGet(stats));
+	HOST_CHECK(snapshots > 0);
+	HOST_CHECK_EQUAL(torn, 0u);
+	HOST_CHECK_EQUAL(backwards, 0u);
+	HOST_CHECK(stats.transactions >= STATS_WRITES);
+	HOST_CHECK_EQUAL(stats.characters, (uint32_t)STATS_WRITES);
+	printf("snapshots %u during %u transactions\n", (unsigned)snapshots, (unsigned)stats.transactions);
+
+	HOST_CHECK_EQUAL(device.busyWrites, 0u);
+	return HOST_TEST_END();
+}
@@ -0,0 +1,95 @@
+/*!
+	@file     TestTrace.cpp
+	@author   Gavin Lyons
+	@brief    Host test, a busy flag read is traced with its strobe writes and the bytes read.
+	@details The dump is written to trace_capture.bin in the working directory,
+		the trace_tool test decodes it with extra/tools/hd44780_trace.py.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include "hd44780/HD44780_LCD_PCF8574.hpp"
+#include "HD44780_HostBus.hpp"
+#include "HostTest.hpp"
+
+/*! One record of the dump */
+struct TraceRecord
+{
+	uint16_t length;
+	uint8_t flags;
+	std::vector<uint8_t> port;
+};
+
+/*! Send the dump to a file instead of stdout */
+static size_t dumpToFile(HD44780LCD &lcd, const char *path)
+{
+	fflush(stdout);
+	FILE *capture = fopen(path, "wb");
+	if (capture == nullptr) {return 0;}
+	int saved = dup(fileno(stdout));
+	dup2(fileno(capture), fileno(stdout));
+	size_t written = lcd.LCDTraceDump();
+	fflush(stdout);
+	dup2(saved, fileno(stdout));
+	close(saved);
+	fclose(capture);
+	return written;
+}
+
+int main()
+{
+	hostBus.BusReset();
+	HD44780LCD lcd(0x27, i2c1, 100, 18, 19);
+	HOST_CHECK(lcd.LCDInit(lcd.LCDCursorTypeOff, 2, 16));
+	lcd.LCDGOTO(lcd.LCDLineNumberOne, 5);
+	HOST_CHECK(lcd.LCDTraceModeSet(true));
+	HOST_CHECK_EQUAL(lcd.LCDReadAddressCounter(), (int16_t)0x05);
+
+	size_t written = dumpToFile(lcd, "trace_capture.bin");
+	HOST_CHECK(written > 16);
+	FILE *capture = fopen("trace_capture.bin", "rb");
+	HOST_CHECK(capture != nullptr);
+	if (capture == nullptr) {return HOST_TEST_END();}
+	std::vector<uint8_t> data(written);
+	HOST_CHECK_EQUAL(fread(data.data(), 1, written, capture), written);
+	fclose(capture);
+	HOST_CHECK(memcmp(data.data(), "HDT1", 4) == 0);
+
+	// strobe write, read upper nibble, strobe write, read lower nibble, enable low
+	std::vector<TraceRecord> records;
+	for (size_t i = 16; i + 11 <= data.size();)
+	{
+		TraceRecord record;
+		record.length = data[i + 8] | (data[i + 9] << 8);
+		record.flags = data[i + 10];
+		record.port.assign(data.begin() + i + 11, data.begin() + i + 11 + record.length);
+		records.push_back(record);
+		i += 11 + record.length;
+	}
+	HOST_CHECK_EQUAL(records.size(), (size_t)5);
+	if (records.size() != 5) {return HOST_TEST_END();}
+	const uint8_t readFlag = 0x08;
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		HOST_CHECK_EQUAL(records[i].flags, (uint8_t)((i == 1 || i == 3) ? readFlag : 0));
+		HOST_CHECK_EQUAL(records[i].length, (uint16_t)((i == 1 || i == 3 || i == 4) ? 1 : 2));
+	}
+	HOST_CHECK_EQUAL(records[1].port[0] & 0xF0, 0x00);
+	HOST_CHECK_EQUAL(records[3].port[0] & 0xF0, 0x50);
+
+	// the first strobe write is not acknowledged, the read stops there and is flagged
+	hostBus.faultNacks = 1;
+	HOST_CHECK_EQUAL(lcd.LCDReadAddressCounter(), (int16_t)-1);
+	written = dumpToFile(lcd, "trace_failed.bin");
+	HOST_CHECK_EQUAL(written, (size_t)(16 + 11 + 2));
+	capture = fopen("trace_failed.bin", "rb");
+	HOST_CHECK(capture != nullptr);
+	if (capture == nullptr) {return HOST_TEST_END();}
+	HOST_CHECK_EQUAL(fread(data.data(), 1, written, capture), written);
+	fclose(capture);
+	HOST_CHECK_EQUAL(data[16 + 10], (uint8_t)0x01);
+
+	return HOST_TEST_END();
+}
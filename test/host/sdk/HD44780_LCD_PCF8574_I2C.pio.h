@@ -0,0 +1,60 @@
+/*!
+	@file     HD44780_LCD_PCF8574_I2C.pio.h
+	@brief    Host stand in for the header pioasm makes from HD44780_LCD_PCF8574_I2C.pio
+	@details Same instruction words as pioasm output, TestPIO checks them against the .pio source.
+		Update them with the .pio file.
+*/
+
+#ifndef HOST_HD44780_I2C_PIO_H
+#define HOST_HD44780_I2C_PIO_H
+
+#include "hardware/pio.h"
+
+#define hd44780_i2c_wrap_target 0
+#define hd44780_i2c_wrap 21
+
+#define hd44780_i2c_offset_entry_point 0u
+
+static const uint16_t hd44780_i2c_program_instructions[] = {
+	//     .wrap_target
+	0x80a0, //  0: pull   block
+	0x6021, //  1: out    x, 1
+	0x0027, //  2: jmp    !x, 7
+	0xf780, //  3: set    pindirs, 0      side 0 [7]
+	0x27a1, //  4: wait   1 pin, 1               [7]
+	0xe781, //  5: set    pindirs, 1             [7]
+	0xbf42, //  6: nop                    side 1 [7]
+	0x6041, //  7: out    y, 1
+	0xe027, //  8: set    x, 7
+	0x6781, //  9: out    pindirs, 1             [7]
+	0xb742, // 10: nop                    side 0 [7]
+	0x27a1, // 11: wait   1 pin, 1               [7]
+	0x1f49, // 12: jmp    x--, 9          side 1 [7]
+	0xe780, // 13: set    pindirs, 0             [7]
+	0xb742, // 14: nop                    side 0 [7]
+	0x27a1, // 15: wait   1 pin, 1               [7]
+	0x00d6, // 16: jmp    pin, 22
+	0x1f60, // 17: jmp    !y, 0           side 1 [7]
+	0xe781, // 18: set    pindirs, 1             [7]
+	0xb742, // 19: nop                    side 0 [7]
+	0x27a1, // 20: wait   1 pin, 1               [7]
+	0xe780, // 21: set    pindirs, 0             [7]
+	//     .wrap
+	0xbf42, // 22: nop                    side 1 [7]
+	0xe781, // 23: set    pindirs, 1             [7]
+	0xb742, // 24: nop                    side 0 [7]
+	0x27a1, // 25: wait   1 pin, 1               [7]
+	0xe780, // 26: set    pindirs, 0             [7]
+	0xc030, // 27: irq    wait 0 rel
+	0x0000, // 28: jmp    0
+};
+
+static const pio_program_t hd44780_i2c_program = {
+	hd44780_i2c_program_instructions,
+	29,
+	-1,
+};
+
+void hd44780_i2c_program_init(PIO pio, uint sm, uint offset, uint sda, uint freqKHz);
+
+#endif
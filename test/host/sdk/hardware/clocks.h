@@ -0,0 +1,15 @@
+/*!
+	@file     clocks.h
+	@brief    Host stand in for the Pico SDK hardware/clocks.h
+*/
+
+#ifndef HOST_HARDWARE_CLOCKS_H
+#define HOST_HARDWARE_CLOCKS_H
+
+#include "pico/stdlib.h"
+
+enum clock_index {clk_sys = 5};
+
+uint32_t clock_get_hz(enum clock_index clk);
+
+#endif
@@ -0,0 +1,38 @@
+/*!
+	@file     dma.h
+	@brief    Host stand in for the Pico SDK hardware/dma.h
+	@details Transfers are paced by their DREQ, an I2C TX transfer moves a word each time
+		the simulated TX FIFO has room.
+*/
+
+#ifndef HOST_HARDWARE_DMA_H
+#define HOST_HARDWARE_DMA_H
+
+#include "pico/stdlib.h"
+
+#define NUM_DMA_CHANNELS 12
+
+enum dma_channel_transfer_size {DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2};
+
+typedef struct {
+	uint32_t ctrl;
+	uint dreq;
+	enum dma_channel_transfer_size size;
+	bool readIncrement;
+	bool writeIncrement;
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+bool dma_channel_is_claimed(uint channel);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config *config, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *config, bool increment);
+void channel_config_set_write_increment(dma_channel_config *config, bool increment);
+void channel_config_set_dreq(dma_channel_config *config, uint dreq);
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *writeAddress,
+	const volatile void *readAddress, uint transferCount, bool trigger);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_abort(uint channel);
+
+#endif
@@ -0,0 +1,11 @@
+/*!
+	@file     gpio.h
+	@brief    Host stand in for the Pico SDK hardware/gpio.h
+*/
+
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+
+#include "pico/stdlib.h"
+
+#endif
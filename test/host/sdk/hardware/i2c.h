@@ -0,0 +1,67 @@
+/*!
+	@file     i2c.h
+	@brief    Host stand in for the Pico SDK hardware/i2c.h
+	@details The I2C blocks are simulated by the bus emulator, see HD44780_HostBus.hpp.
+		Register reads and writes go to the emulator, the TX FIFO drains at the bus clock.
+		A discarded read such as (void)hw->clr_tx_abrt does not reach the emulator, so a
+		read of raw_intr_stat or intr_stat clears TX_ABRT once it has been reported.
+*/
+
+#ifndef HOST_HARDWARE_I2C_H
+#define HOST_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+/*! One register of a simulated I2C block */
+struct HostI2CRegister {
+	HostI2CRegister &operator=(uint32_t value);
+	operator uint32_t() const;
+	uint32_t _value;
+};
+
+/*! Register map of an I2C block, same layout as the RP2040 */
+typedef struct {
+	HostI2CRegister con, tar, sar, _pad0, data_cmd, ss_scl_hcnt, ss_scl_lcnt, fs_scl_hcnt, fs_scl_lcnt,
+		_pad1[2], intr_stat, intr_mask, raw_intr_stat, rx_tl, tx_tl, clr_intr, clr_rx_under, clr_rx_over,
+		clr_tx_over, clr_rd_req, clr_tx_abrt, clr_rx_done, clr_activity, clr_stop_det, clr_start_det,
+		clr_gen_call, enable, status, txflr, rxflr, sda_hold, tx_abrt_source, slv_data_nack_only,
+		dma_cr, dma_tdlr, dma_rdlr;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+	i2c_hw_t *hw;
+	bool restart_on_next;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400
+#define I2C_IC_INTR_MASK_M_TX_EMPTY_BITS 0x00000010
+#define I2C_IC_INTR_MASK_M_TX_ABRT_BITS 0x00000040
+#define I2C_IC_INTR_STAT_R_TX_EMPTY_BITS 0x00000010
+#define I2C_IC_INTR_STAT_R_TX_ABRT_BITS 0x00000040
+#define I2C_IC_RAW_INTR_STAT_TX_EMPTY_BITS 0x00000010
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS 0x00000040
+#define I2C_IC_STATUS_ACTIVITY_BITS 0x00000001
+#define I2C_IC_STATUS_TFE_BITS 0x00000004
+#define I2C_IC_ENABLE_ENABLE_BITS 0x00000001
+#define I2C_IC_CON_TX_EMPTY_CTRL_BITS 0x00000100
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+void i2c_deinit(i2c_inst_t *i2c);
+uint i2c_set_baudrate(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop, uint timeout_us);
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop, uint timeout_us);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+size_t i2c_get_write_available(i2c_inst_t *i2c);
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {return i2c->hw;}
+static inline uint i2c_hw_index(i2c_inst_t *i2c) {return i2c == i2c1 ? 1 : 0;}
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool isTx) {return 32 + 2 * i2c_hw_index(i2c) + (isTx ? 0 : 1);}
+
+#endif
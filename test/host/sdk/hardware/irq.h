@@ -0,0 +1,24 @@
+/*!
+	@file     irq.h
+	@brief    Host stand in for the Pico SDK hardware/irq.h
+	@details An enabled handler is called by the bus emulator when its interrupt is raised,
+		on the thread that enabled it and only while that thread has interrupts on.
+*/
+
+#ifndef HOST_HARDWARE_IRQ_H
+#define HOST_HARDWARE_IRQ_H
+
+#include "pico/stdlib.h"
+
+#define I2C0_IRQ 23
+#define I2C1_IRQ 24
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+irq_handler_t irq_get_exclusive_handler(uint num);
+bool irq_has_shared_handler(uint num);
+void irq_remove_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+
+#endif
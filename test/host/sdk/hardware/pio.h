@@ -0,0 +1,62 @@
+/*!
+	@file     pio.h
+	@brief    Host stand in for the Pico SDK hardware/pio.h
+	@details State machines are run an instruction per cycle by the PIO simulator on the
+		bus clock, see HD44780_HostPIO.hpp. Instruction memory, FIFOs, IRQ flags and
+		FDEBUG TXSTALL behave as on the RP2040.
+*/
+
+#ifndef HOST_HARDWARE_PIO_H
+#define HOST_HARDWARE_PIO_H
+
+#include "pico/stdlib.h"
+
+#define PIO_FDEBUG_TXSTALL_LSB 24
+
+/*! FDEBUG of a simulated PIO block, bits are set by the simulator and cleared by writing 1 */
+struct HostPIODebugRegister {
+	HostPIODebugRegister &operator=(uint32_t value);
+	operator uint32_t() const;
+	uint32_t _value;
+};
+
+typedef struct {
+	volatile uint32_t ctrl, fstat;
+	HostPIODebugRegister fdebug;
+	volatile uint32_t flevel;
+	volatile uint32_t txf[4];
+	volatile uint32_t rxf[4];
+	volatile uint32_t irq;
+} pio_hw_t;
+typedef pio_hw_t *PIO;
+
+extern pio_hw_t host_pio0_hw;
+extern pio_hw_t host_pio1_hw;
+#define pio0 (&host_pio0_hw)
+#define pio1 (&host_pio1_hw)
+
+typedef struct {
+	const uint16_t *instructions;
+	uint8_t length;
+	int8_t origin;
+} pio_program_t;
+
+enum pio_fifo_join {PIO_FIFO_JOIN_NONE = 0, PIO_FIFO_JOIN_TX = 1, PIO_FIFO_JOIN_RX = 2};
+
+bool pio_can_add_program(PIO pio, const pio_program_t *program);
+uint pio_add_program(PIO pio, const pio_program_t *program);
+void pio_remove_program(PIO pio, const pio_program_t *program, uint offset);
+void pio_sm_claim(PIO pio, uint sm);
+void pio_sm_unclaim(PIO pio, uint sm);
+bool pio_sm_is_claimed(PIO pio, uint sm);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+uint pio_get_dreq(PIO pio, uint sm, bool isTx);
+bool pio_interrupt_get(PIO pio, uint num);
+void pio_interrupt_clear(PIO pio, uint num);
+void pio_sm_clear_fifos(PIO pio, uint sm);
+void pio_sm_restart(PIO pio, uint sm);
+void pio_sm_exec(PIO pio, uint sm, uint instruction);
+static inline uint pio_encode_jmp(uint address) {return address;} // JMP always is opcode 0
+
+#endif
@@ -0,0 +1,20 @@
+/*!
+	@file     sync.h
+	@brief    Host stand in for the Pico SDK hardware/sync.h spin locks
+	@details Each lock is an atomic flag, taken with this thread's interrupts off as on the RP2040.
+*/
+
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include <atomic>
+#include "pico/stdlib.h"
+
+typedef std::atomic_flag spin_lock_t;
+
+spin_lock_t *spin_lock_instance(uint lock_num);
+uint next_striped_spin_lock_num(void);
+uint32_t spin_lock_blocking(spin_lock_t *lock);
+void spin_unlock(spin_lock_t *lock, uint32_t saved_irq);
+
+#endif
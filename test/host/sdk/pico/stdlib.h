@@ -0,0 +1,67 @@
+/*!
+	@file     stdlib.h
+	@brief    Host stand in for the Pico SDK pico/stdlib.h, time and GPIO run on the simulated bus clock.
+*/
+
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+enum {PICO_OK = 0, PICO_ERROR_GENERIC = -1, PICO_ERROR_TIMEOUT = -2};
+
+#define GPIO_FUNC_I2C 3
+#define GPIO_FUNC_PIO0 6
+#define GPIO_FUNC_PIO1 7
+#define GPIO_FUNC_SIO 5
+#define GPIO_FUNC_NULL 0x1f
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+#define __not_in_flash(group)
+#define __not_in_flash_func(func) func
+#define __time_critical_func(func) func
+
+// time , the clock only moves when waited on, polled or when the bus is busy
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+absolute_time_t get_absolute_time(void);
+absolute_time_t make_timeout_time_us(uint64_t us);
+absolute_time_t make_timeout_time_ms(uint32_t ms);
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us);
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to);
+uint64_t to_us_since_boot(absolute_time_t t);
+bool time_reached(absolute_time_t t);
+void busy_wait_us_32(uint32_t us);
+void busy_wait_us(uint64_t us);
+void busy_wait_ms(uint32_t ms);
+void busy_wait_until(absolute_time_t t);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+// gpio
+void gpio_init(uint gpio);
+void gpio_set_function(uint gpio, uint fn);
+void gpio_pull_up(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+
+// interrupts , per thread, a thread stands in for a core
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+static inline void tight_loop_contents(void) {}
+static inline void __compiler_memory_barrier(void) {__asm__ volatile ("" : : : "memory");}
+
+// stdio
+bool stdio_init_all(void);
+int putchar_raw(int c);
+void stdio_flush(void);
+
+#endif